@@ -0,0 +1,127 @@
+/*
+ *  Adaptive search
+ *
+ *  Copyright (C) 2002-2011 Daniel Diaz, Philippe Codognet and Salvador Abreu
+ *
+ *  ad_problem.h: problem descriptors (built-in problems and plugins of adsolve)
+ */
+
+#ifndef AD_PROBLEM_H
+#define AD_PROBLEM_H 1
+
+#include "ad_solver.h"
+
+/*
+ *  A bench is usually linked alone with libad_solver.a: the engine
+ *  calls the user functions (Cost_Of_Solution...) by name and the
+ *  no_xxx.c wrappers are linked for the missing optional ones.
+ *
+ *  adsolve hosts several problems: a problem is then an AdProblem (its
+ *  functions and variables) and adsolve defines the user functions as
+ *  forwarders to the selected problem (see adsolve.c).
+ *
+ *  A bench source becomes a problem without modification: it is compiled
+ *  with -include ad_problem.h -DAD_PROBLEM=id -DAD_PROBLEM_NAME=\"name\"
+ *  which defines the descriptor ad_problem_<id> below (and renames the
+ *  variables of main.c it defines). Then:
+ *
+ *  - built-in: the user functions of the object are made local
+ *    (objcopy --localize-symbol, see AD_USER_FCT in the Makefile),
+ *  - plugin: the object is linked in a shared object <name>.so with
+ *    -Bsymbolic-functions (its calls go to its own functions).
+ *
+ *  An optional function not defined by the problem is a weak reference
+ *  resolved to the forwarder of adsolve (or NULL): adsolve then uses the
+ *  default (the behavior of the no_xxx.c wrapper).
+ */
+
+/*-------*
+ * Types *
+ *-------*/
+
+typedef struct
+{
+  char *name;			/* name of the problem (e.g. "qap") */
+
+				/* variables of main.c overwritten by the bench (or NULL) */
+  int *param_needed;		/* > 0 = integer, < 0 = file name, 0 = none */
+  char **user_stat_name;
+  int (**user_stat_fct)(AdData *p_ad);
+
+				/* mandatory */
+  void (*init_parameters)(AdData *p_ad);
+  void (*solve)(AdData *p_ad);
+  int (*check_solution)(AdData *p_ad);
+  int (*cost_of_solution)(int should_be_recorded);
+
+				/* optional (see ad_solver.h) */
+  void (*set_init_configuration)(AdData *p_ad);
+  void (*check_init_configuration)(AdData *p_ad);
+  int (*cost_on_variable)(int i);
+  void (*cost_on_all_variables)(int *err);
+  int (*cost_if_swap)(int current_cost, int i, int j);
+  int (*cost_if_move)(int current_cost, int *var, int nb_var);
+  void (*executed_swap)(int i, int j);
+  int (*next_i)(int i);
+  int (*next_j)(int i, int j, int exhaustive);
+  int (*reset)(int nb_to_reset, AdData *p_ad);
+  void (*display_solution)(AdData *p_ad);
+  void (*free_problem)(AdData *p_ad);
+  int (*apply_delta)(AdData *p_ad, char *delta);
+} AdProblem;
+
+
+
+/*------------------------*
+ * Descriptor of a bench  *
+ *------------------------*/
+
+#ifdef AD_PROBLEM
+
+#define AD_PB_CAT(a, b)   AD_PB_CAT1(a, b)
+#define AD_PB_CAT1(a, b)  a##b
+
+#define param_needed      AD_PB_CAT(AD_PROBLEM, _param_needed)
+#define user_stat_name    AD_PB_CAT(AD_PROBLEM, _user_stat_name)
+#define user_stat_fct     AD_PB_CAT(AD_PROBLEM, _user_stat_fct)
+
+void Init_Parameters(AdData *p_ad);
+
+void Solve(AdData *p_ad);
+
+int Check_Solution(AdData *p_ad);
+
+extern int param_needed __attribute__ ((weak));
+extern char *user_stat_name __attribute__ ((weak));
+extern int (*user_stat_fct)(AdData *p_ad) __attribute__ ((weak));
+
+#define AD_PB_WEAK(f)  extern __typeof__(f) f __attribute__ ((weak))
+
+AD_PB_WEAK(Set_Init_Configuration);
+AD_PB_WEAK(Check_Init_Configuration);
+AD_PB_WEAK(Cost_On_Variable);
+AD_PB_WEAK(Cost_On_All_Variables);
+AD_PB_WEAK(Cost_If_Swap);
+AD_PB_WEAK(Cost_If_Move);
+AD_PB_WEAK(Executed_Swap);
+AD_PB_WEAK(Next_I);
+AD_PB_WEAK(Next_J);
+AD_PB_WEAK(Reset);
+AD_PB_WEAK(Display_Solution);
+AD_PB_WEAK(Free_Problem);
+AD_PB_WEAK(Apply_Delta);
+
+AdProblem AD_PB_CAT(ad_problem_, AD_PROBLEM) = {
+  AD_PROBLEM_NAME,
+  &param_needed, &user_stat_name, &user_stat_fct,
+  Init_Parameters, Solve, Check_Solution, Cost_Of_Solution,
+  Set_Init_Configuration, Check_Init_Configuration,
+  Cost_On_Variable, Cost_On_All_Variables,
+  Cost_If_Swap, Cost_If_Move, Executed_Swap,
+  Next_I, Next_J, Reset,
+  Display_Solution, Free_Problem, Apply_Delta
+};
+
+#endif /* AD_PROBLEM */
+
+#endif /* !AD_PROBLEM_H */
@@ -10,12 +10,23 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
+#include <math.h>
 
 #define AD_SOLVER_FILE
 
 #include "ad_solver.h"
 #include "tools.h"
 
+#ifdef LOG_FILE
+#include "ad_trace.h"
+#endif
+
+#if defined(PERF_COUNTERS) && defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
 
 
 /*-----------*
@@ -24,6 +35,16 @@
 
 #define BIG ((unsigned int) -1 >> 1)
 
+#define MOVE_NB_VAR  4		/* a compound move = 2 swaps: (v0,v1) then (v2,v3) */
+
+#define ADAPT_MIN_WINDOW  64	/* adaptive control: min nb of iters between 2 adjustments */
+
+#define ADAPT_FREEZE_LOC_MIN   0
+#define ADAPT_FREEZE_SWAP      1
+#define ADAPT_RESET_LIMIT      2
+#define ADAPT_NB_VAR_TO_RESET  3
+#define ADAPT_NB_PARAMS        4
+
 
 
 /*-------*
@@ -36,6 +57,15 @@ typedef struct
 }Pair;
 
 
+typedef struct			/* a parameter adapted during the run */
+{
+  int *p;			/* the parameter (in p_ad) */
+  int base;			/* its initial value */
+  int lo, hi;			/* bounds */
+  int step;
+}AdaptParam;
+
+
 /*------------------*
  * Global variables *
  *------------------*/
@@ -64,8 +94,33 @@ static int list_j_nb;		/* nb of elements of the list */
 static Pair *list_ij;		/* list of max/min (exhaustive) */
 static int list_ij_nb;		/* nb of elements of the list */
 
+static char *in_conflict;	/* in_conflict[i] != 0 iff i is in ad_conflict[] */
+
+static int *var_cost;		/* filled by Cost_On_All_Variables (if defined) */
+
+static int work_size;		/* size of the work arrays (kept from a call to another) */
+static int *work_var_cost;	/* var_cost if used */
+static int *work_best_sol;	/* overall_best_sol if used */
+
+static AdaptParam adapt[ADAPT_NB_PARAMS]; /* adaptive control (p_ad->adaptive) */
+static int adapt_window;	/* nb of iters between 2 adjustments */
+static int adapt_best_cost;	/* best_cost at the beginning of the window */
+static int adapt_nb_plateau;	/* nb of iters without cost change in the window */
+static int adapt_nb_reset;	/* p_ad->nb_reset at the beginning of the window */
+
+static int restart_iter_limit;	/* nb of iters of the current run (see Restart_Limit) */
+static int restart_iter_ref;	/* AD_RESTART_PROGRESS: iter of the last improvement */
+
 #ifdef LOG_FILE
-static FILE *f_log;		/* log file */
+static AdTrace trace;		/* binary log file (see ad_trace.c) */
+static int trace_on;		/* trace opened ? */
+#endif
+
+#ifdef PERF_COUNTERS
+static int perf_fd[AD_NB_COUNTERS]; /* [AD_CNT_NS] unused, -1 if not available */
+static int perf_group;		/* hw counters in one group (one read for all) */
+static long long perf_start[AD_NB_COUNTERS];
+static int perf_start_ok;	/* the counters of perf_start could be read ? */
 #endif
 
 
@@ -77,6 +132,10 @@ static FILE *f_log;		/* log file */
 
 #define USE_PROB_SELECT_LOC_MIN ((unsigned) p_ad->prob_select_loc_min <= 100)
 
+				/* default Next_I / Next_J (see no_next_i.c, no_next_j.c) without a call */
+#define Ad_Next_I(i)        ((ad_no_next_i_fct) ? (i) + 1 : Next_I(i))
+#define Ad_Next_J(i, j, e)  ((ad_no_next_j_fct) ? (((j) < 0 && (e)) ? (i) + 1 : (j) + 1) : Next_J(i, j, e))
+
 
 
 
@@ -97,6 +156,19 @@ static void Show_Debug_Info(void);
 #endif
 
 
+#ifdef PERF_COUNTERS
+static void Perf_Init(void);
+static int Perf_Read(long long *val);
+static void Perf_Add(int phase);
+
+#define Perf_Begin()     (perf_start_ok = Perf_Read(perf_start))
+#define Perf_End(phase)  Perf_Add(phase)
+#else
+#define Perf_Begin()
+#define Perf_End(phase)
+#endif
+
+
 
 #if defined(DEBUG) && (DEBUG&1)
 /*
@@ -129,56 +201,153 @@ Ad_Un_Mark(int i)
 
 
 
+/*
+ *  AD_CONFLICT_ADD
+ *
+ *  Records that the variable i may be in conflict (conflict set mode).
+ *
+ *  In this mode max_i is only selected among ad_conflict[]. The set can
+ *  contain vars without error: they are removed when the set is scanned.
+ *  The engine adds the 2 swapped vars, the user Executed_Swap should add 
+ *  other vars whose error can become > 0. If the set runs out while the 
+ *  target is not reached it is rebuilt from all variables.
+ */
+void
+Ad_Conflict_Add(int i)
+{
+  if (!in_conflict[i])
+    {
+      in_conflict[i] = 1;
+      ad_conflict[ad_nb_conflict++] = i;
+    }
+}
+
+
+
+/*
+ *  CONFLICT_REBUILD
+ *
+ *  Records all variables with an error in the conflict set.
+ */
+static void
+Conflict_Rebuild(void)
+{
+  int i;
+
+  ad_nb_conflict = 0;
+  memset(in_conflict, 0, p_ad->size);
+
+  for(i = 0; i < p_ad->size; i++)
+    if (Cost_On_Variable(i) > 0)
+      Ad_Conflict_Add(i);
+}
+
+
+
 /*
  *  SELECT_VAR_HIGH_COST
  *
  *  Computes err_swap and selects the maximum of err_var in max_i.
  *  Also computes the number of marked variables.
+ *  In conflict set mode only vars of ad_conflict[] are considered
+ *  (all vars are considered if they are all marked).
  */
 static void
 Select_Var_High_Cost(void)
 {
-  int i;
+  int i, k;
   int x, max;
 
   list_i_nb = 0;
   max = 0;
   nb_var_marked = 0;
   
-  i = -1;
-  while((unsigned) (i = Next_I(i)) < (unsigned) p_ad->size) // false if i < 0
+  if (p_ad->conflict_set)
     {
-      if (Marked(i))
+      if (ad_nb_conflict == 0 && !TARGET_REACHED(p_ad))
+	Conflict_Rebuild();
+
+      k = 0;
+      while(k < ad_nb_conflict)
 	{
+	  i = ad_conflict[k];
+	  x = Cost_On_Variable(i);
 #if defined(DEBUG) && (DEBUG&1)
-	  err_var[i] = Cost_On_Variable(i);
+	  err_var[i] = x;
 #endif
-	  nb_var_marked++;
-	  continue;
+	  if (x == 0)		/* no longer in conflict: remove it */
+	    {
+	      in_conflict[i] = 0;
+	      ad_conflict[k] = ad_conflict[--ad_nb_conflict];
+	      if (ad_nb_conflict == 0 && !TARGET_REACHED(p_ad))
+		Conflict_Rebuild();
+	      continue;
+	    }
+	  k++;
+
+	  if (Marked(i))
+	    {
+	      nb_var_marked++;
+	      continue;
+	    }
+
+	  if (x >= max)
+	    {
+	      if (x > max)
+		{
+		  max = x;
+		  list_i_nb = 0;
+		}
+	      list_i[list_i_nb++] = i;
+	    }
 	}
+    }
 
-      x = Cost_On_Variable(i);
+  if (list_i_nb == 0)		/* no conflict set or all its vars are marked */
+    {
+      max = 0;
+      nb_var_marked = 0;
+      if (var_cost)		/* batch evaluation: vars from 0 to size-1 */
+	Cost_On_All_Variables(var_cost);
+
+      i = -1;
+      while((unsigned) (i = (var_cost) ? i + 1 : Ad_Next_I(i)) < (unsigned) p_ad->size) // false if i < 0
+	{
+	  if (Marked(i))
+	    {
 #if defined(DEBUG) && (DEBUG&1)
-      err_var[i] = x;
+	      err_var[i] = (var_cost) ? var_cost[i] : Cost_On_Variable(i);
 #endif
+	      nb_var_marked++;
+	      continue;
+	    }
 
-      if (x >= max)
-	{
-	  if (x > max)
+	  x = (var_cost) ? var_cost[i] : Cost_On_Variable(i);
+#if defined(DEBUG) && (DEBUG&1)
+	  err_var[i] = x;
+#endif
+
+	  if (x >= max)
 	    {
-	      max = x;
-	      list_i_nb = 0;
+	      if (x > max)
+		{
+		  max = x;
+		  list_i_nb = 0;
+		}
+	      list_i[list_i_nb++] = i;
 	    }
-	  list_i[list_i_nb++] = i;
 	}
     }
 
-  /* here list_i_nb == 0 iff all vars are marked or bad Cost_On_Variable() */
+  /* here list_i_nb == 0 iff all vars are marked or bad Cost_On_Variable()
+   * (only vars returned by Next_I or in the conflict set are considered)
+   */
 
-#if defined(DEBUG) && (DEBUG&1)
   if (list_i_nb == 0)
-    Error_All_Marked();
-#endif
+    {
+      max_i = -1;
+      return;
+    }
 
   p_ad->nb_same_var += list_i_nb;
   x = Random(list_i_nb);
@@ -204,7 +373,7 @@ Select_Var_Min_Conflict(void)
   new_cost = p_ad->total_cost;
 
   j = -1;
-  while((unsigned) (j = Next_J(max_i, j, 0)) < (unsigned) p_ad->size) // false if j < 0
+  while((unsigned) (j = Ad_Next_J(max_i, j, 0)) < (unsigned) p_ad->size) // false if j < 0
     {
 #if defined(DEBUG) && (DEBUG&1)
       swap[j] = Cost_If_Swap(p_ad->total_cost, j, max_i);
@@ -293,7 +462,7 @@ Select_Vars_To_Swap(void)
   nb_var_marked = 0;
 
   i = -1;
-  while((unsigned) (i = Next_I(i)) < (unsigned) p_ad->size) // false if i < 0
+  while((unsigned) (i = Ad_Next_I(i)) < (unsigned) p_ad->size) // false if i < 0
     {
       if (Marked(i))
 	{
@@ -303,7 +472,7 @@ Select_Vars_To_Swap(void)
 #endif
 	}
       j = -1;
-      while((unsigned) (j = Next_J(i, j, i + 1)) < (unsigned) p_ad->size) // false if j < 0
+      while((unsigned) (j = Ad_Next_J(i, j, i + 1)) < (unsigned) p_ad->size) // false if j < 0
 	{
 #ifndef IGNORE_MARK_IF_BEST
 	  if (Marked(j))
@@ -409,6 +578,8 @@ Ad_Swap(int i, int j)
 static void
 Do_Reset(int n)
 {
+  Perf_Begin();
+
 #if defined(DEBUG) && (DEBUG&1)
   if (p_ad->debug)
     printf(" * * * * * * RESET n=%d\n", n);
@@ -425,6 +596,11 @@ Do_Reset(int n)
 #endif
   p_ad->nb_reset++;
   p_ad->total_cost = (cost < 0) ? Cost_Of_Solution(1) : cost;
+
+  if (p_ad->conflict_set)
+    Conflict_Rebuild();
+
+  Perf_End(AD_PHASE_RESET);
 }
 
 
@@ -432,58 +608,195 @@ Do_Reset(int n)
 /*
  *  EMIT_LOG
  *
+ *  Records an event (AD_TRACE_xxx) in the binary log (use adtrace to
+ *  decode it). Only a few stores in a ring buffer, the file is written
+ *  by another thread.
  */
 #ifdef LOG_FILE
-#define Emit_Log(...)					\
-  do if (f_log)						\
-    {							\
-      fprintf(f_log, __VA_ARGS__);			\
-      fputc('\n', f_log);				\
-      fflush(f_log);					\
-  } while(0)
+#define Emit_Log(type, v0, v1, v2, v3, v4)				\
+  do if (trace_on)							\
+    Ad_Trace_Put(&trace, type, p_ad->nb_iter, p_ad->total_cost,	\
+		 v0, v1, v2, v3, v4);					\
+  while(0)
 #else
-#define Emit_Log(...)
+#define Emit_Log(type, v0, v1, v2, v3, v4)
 #endif
 
 
 
 
 /*
- *  AD_SOLVE
+ *  ADAPT_INIT
  *
- *  General solve function.
- *  returns the final total_cost (0 on success)
+ *  Records the initial values of the adapted parameters and their bounds
+ *  (from half to twice the initial value).
  */
-int
-Ad_Solve(AdData *p_ad0)
+static void
+Adapt_Init(void)
 {
-  int nb_in_plateau;
+  static int step_div[ADAPT_NB_PARAMS] = { 0, 0, 8, 4 };
+  AdaptParam *a;
+  int k;
 
-  p_ad = p_ad0;
+  adapt[ADAPT_FREEZE_LOC_MIN].p = &p_ad->freeze_loc_min;
+  adapt[ADAPT_FREEZE_SWAP].p = &p_ad->freeze_swap;
+  adapt[ADAPT_RESET_LIMIT].p = &p_ad->reset_limit;
+  adapt[ADAPT_NB_VAR_TO_RESET].p = &p_ad->nb_var_to_reset;
 
-  ad_sol = p_ad->sol; /* copy of p_ad->sol and p_ad->reinit_after_if_swap (used by no_cost_swap) */
-  ad_reinit_after_if_swap = p_ad->reinit_after_if_swap;
+  for(k = 0; k < ADAPT_NB_PARAMS; k++)
+    {
+      a = &adapt[k];
+      a->base = *a->p;
+      a->lo = a->base / 2;
+      a->hi = 2 * a->base + 2;
+      a->step = (step_div[k] && a->base / step_div[k] > 1) ? a->base / step_div[k] : 1;
+    }
 
+  a = &adapt[ADAPT_RESET_LIMIT];
+  if (a->lo < 1)
+    a->lo = 1;
+  if (a->hi > p_ad->size - 1)
+    a->hi = p_ad->size - 1;
 
-  if (ad_no_cost_var_fct)
-    p_ad->exhaustive = 1;
+  a = &adapt[ADAPT_NB_VAR_TO_RESET];
+  if (a->lo < 2)
+    a->lo = 2;
+  if (a->hi > p_ad->size)
+    a->hi = p_ad->size;
+
+  adapt_window = (p_ad->size > ADAPT_MIN_WINDOW) ? p_ad->size : ADAPT_MIN_WINDOW;
+}
 
 
-  mark = (unsigned *) malloc(p_ad->size * sizeof(unsigned));
-  if (p_ad->exhaustive <= 0)
+
+
+/*
+ *  ADAPT_START
+ *
+ *  (Re)starts the control from the initial values (at each restart and
+ *  at the end of Ad_Solve).
+ */
+static void
+Adapt_Start(void)
+{
+  int k;
+
+  for(k = 0; k < ADAPT_NB_PARAMS; k++)
+    *adapt[k].p = adapt[k].base;
+
+  adapt_best_cost = best_cost;
+  adapt_nb_plateau = 0;
+  adapt_nb_reset = p_ad->nb_reset;
+}
+
+
+
+
+/*
+ *  ADAPT_MOVE
+ *
+ *  Moves a parameter one step up (dir > 0), down (dir < 0) or back
+ *  toward its initial value (dir = 0), within its bounds.
+ */
+static void
+Adapt_Move(int k, int dir)
+{
+  AdaptParam *a = &adapt[k];
+  int v = *a->p;
+
+  if (dir == 0)			/* back to base (v can be off the grid) */
     {
-      list_i = (int *) malloc(p_ad->size * sizeof(int));
-      list_j = (int *) malloc(p_ad->size * sizeof(int));
+      if (v < a->base)
+	v = (v + a->step < a->base) ? v + a->step : a->base;
+      else if (v > a->base)
+	v = (v - a->step > a->base) ? v - a->step : a->base;
+
+      *a->p = v;
+      return;
     }
-  else
-    list_ij = (Pair *) malloc(p_ad->size * sizeof(Pair)); // to run on Cell limit to p_ad->size instead of p_ad->size*p_ad->size
+
+  v += dir * a->step;
+  if (dir > 0 && v > a->hi)
+    v = a->hi;
+  if (dir < 0 && v < a->lo)
+    v = a->lo;
+
+  *a->p = v;
+}
+
+
+
+
+/*
+ *  ADAPT_PARAMETERS
+ *
+ *  Called every adapt_window iterations (reactive search):
+ *  - if resets were done in the window without improving the best cost
+ *    (stagnation) the search is diversified: local min vars are frozen
+ *    longer, resets are done sooner and reset more vars. Else each of
+ *    these parameters goes back one step toward its initial value.
+ *  - on stagnation, if more than half of the iterations did not change
+ *    the cost (long plateaus) swapped vars are frozen longer (avoids
+ *    cycling on the plateau), else freeze_swap goes back toward its
+ *    initial value.
+ */
+static void
+Adapt_Parameters(void)
+{
+  int stagnation = (best_cost >= adapt_best_cost && p_ad->nb_reset > adapt_nb_reset);
+
+  Adapt_Move(ADAPT_FREEZE_LOC_MIN, (stagnation) ? 1 : 0);
+  Adapt_Move(ADAPT_RESET_LIMIT, (stagnation) ? -1 : 0);
+  Adapt_Move(ADAPT_NB_VAR_TO_RESET, (stagnation) ? 1 : 0);
+  Adapt_Move(ADAPT_FREEZE_SWAP, (stagnation && 2 * adapt_nb_plateau > adapt_window) ? 1 : 0);
+
+  adapt_best_cost = best_cost;
+  adapt_nb_plateau = 0;
+  adapt_nb_reset = p_ad->nb_reset;
+}
+
+
+
+
+/*
+ *  ALLOC_WORK_ARRAYS
+ *
+ *  The work arrays are only (re)allocated when a bigger problem is
+ *  solved: repeated calls to Ad_Solve (-b, server mode) do not malloc.
+ */
+static void
+Alloc_Work_Arrays(int size)
+{
+  if (size <= work_size)
+    return;
+
+  free(mark);
+  free(list_i);
+  free(list_j);
+  free(list_ij);
+  free(ad_conflict);
+  free(in_conflict);
+  free(work_var_cost);
+  free(work_best_sol);
+
+  mark = (unsigned *) malloc(size * sizeof(unsigned));
+  list_i = (int *) malloc(size * sizeof(int));
+  list_j = (int *) malloc(size * sizeof(int));
+  list_ij = (Pair *) malloc(size * sizeof(Pair)); // to run on Cell limit to size instead of size*size
+  ad_conflict = (int *) malloc(size * sizeof(int));
+  in_conflict = (char *) malloc(size);
+  work_var_cost = (int *) malloc(size * sizeof(int));
+  work_best_sol = (int *) malloc(size * sizeof(int));
 
 #if defined(DEBUG) && (DEBUG&1)
-  err_var = (int *) malloc(p_ad->size * sizeof(int));
-  swap = (int *) malloc(p_ad->size * sizeof(int));
+  free(err_var);
+  free(swap);
+  err_var = (int *) malloc(size * sizeof(int));
+  swap = (int *) malloc(size * sizeof(int));
 #endif
 
-  if (mark == NULL || (!p_ad->exhaustive && (list_i == NULL || list_j == NULL)) || (p_ad->exhaustive && list_ij == NULL)
+  if (mark == NULL || list_i == NULL || list_j == NULL || list_ij == NULL
+      || ad_conflict == NULL || in_conflict == NULL || work_var_cost == NULL || work_best_sol == NULL
 #if defined(DEBUG) && (DEBUG&1)
       || err_var == NULL || swap == NULL
 #endif
@@ -493,29 +806,204 @@ Ad_Solve(AdData *p_ad0)
       exit(1);
     }
 
+  work_size = size;
+}
+
+
+
+
+/*
+ *  LUBY
+ *
+ *  Returns the ith element (i >= 1) of the Luby sequence:
+ *  1 1 2 1 1 2 4 1 1 2 1 1 2 4 8 ...
+ */
+static int
+Luby(int i)
+{
+  int k;
+
+  for(;;)
+    {
+      for(k = 1; (1 << k) - 1 < i; k++)
+	;
+      if (i == (1 << k) - 1)
+	return 1 << (k - 1);
+      i -= (1 << (k - 1)) - 1;
+    }
+}
+
+
+
+
+/*
+ *  RESTART_LIMIT
+ *
+ *  Returns the nb of iterations allowed to the kth run (k = 0 for the
+ *  first one) according to p_ad->restart_policy. restart_limit is the
+ *  unit of the Luby and geometric policies.
+ */
+static int
+Restart_Limit(int k)
+{
+  double l = p_ad->restart_limit;
+
+  switch(p_ad->restart_policy)
+    {
+    case AD_RESTART_LUBY:
+      l *= Luby(k + 1);
+      break;
+
+    case AD_RESTART_GEOMETRIC:
+      if (p_ad->restart_grow > 0)
+	l *= pow(1.0 + p_ad->restart_grow / 100.0, k);
+      break;
+    }
+
+  return (l < BIG) ? (int) l : BIG;
+}
+
+
+
+
+/*
+ *  DO_COMPOUND_MOVE
+ *
+ *  Called when no single swap improves the cost. Tries p_ad->move_tries
+ *  random compound moves made of 2 swaps: (max_i,b) then (c,d), i.e. a
+ *  double swap, or (max_i,b) then (b,c), i.e. a 3-cycle (see Cost_If_Move).
+ *  The best move is executed if it improves the cost.
+ *  Returns 1 if a move has been executed, 0 otherwise.
+ */
+static int
+Do_Compound_Move(void)
+{
+  int var[MOVE_NB_VAR], best_var[MOVE_NB_VAR];
+  int best = p_ad->total_cost;
+  int t, k, x;
+
+  for(t = 0; t < p_ad->move_tries; t++)
+    {
+      var[0] = max_i;
+      var[1] = ((t & 1) && min_j != max_i) ? min_j : Random(p_ad->size);
+      if (Random(2))		/* 3-cycle */
+	{
+	  var[2] = var[1];
+	  var[3] = Random(p_ad->size);
+	}
+      else			/* double swap */
+	{
+	  var[2] = Random(p_ad->size);
+	  var[3] = Random(p_ad->size);
+	}
+
+      if (var[1] == var[0] || var[3] == var[2] || var[3] == var[0] ||
+	  Marked(var[1]) || Marked(var[2]) || Marked(var[3]))
+	continue;
+
+      x = Cost_If_Move(p_ad->total_cost, var, MOVE_NB_VAR);
+      if (x < best)
+	{
+	  best = x;
+	  memcpy(best_var, var, sizeof(var));
+	}
+    }
+
+  if (best >= p_ad->total_cost)
+    return 0;
+
+  Emit_Log(AD_TRACE_MOVE, best_var[0], best_var[1], best_var[2], best_var[3], best);
+
+  for(k = 0; k < MOVE_NB_VAR; k += 2)
+    {
+      Mark(best_var[k], p_ad->freeze_swap);
+      Mark(best_var[k + 1], p_ad->freeze_swap);
+      p_ad->total_cost = Cost_If_Swap(p_ad->total_cost, best_var[k], best_var[k + 1]);
+      Ad_Swap(best_var[k], best_var[k + 1]);
+      Executed_Swap(best_var[k], best_var[k + 1]);
+
+      if (p_ad->conflict_set)
+	{
+	  Ad_Conflict_Add(best_var[k]);
+	  Ad_Conflict_Add(best_var[k + 1]);
+	}
+    }
+
+  p_ad->total_cost = best;
+  if (best < best_cost)
+    {
+      best_cost = best;
+      if (p_ad->restart_policy == AD_RESTART_PROGRESS)
+	restart_iter_ref = p_ad->nb_iter;
+    }
+
+  return 1;
+}
+
+
+
+
+/*
+ *  AD_SOLVE
+ *
+ *  General solve function.
+ *  returns the final total_cost (0 on success)
+ */
+int
+Ad_Solve(AdData *p_ad0)
+{
+  int nb_in_plateau;
+
+  p_ad = p_ad0;
+
+  ad_sol = p_ad->sol; /* copy of p_ad->sol and p_ad->reinit_after_if_swap (used by no_cost_swap) */
+  ad_reinit_after_if_swap = p_ad->reinit_after_if_swap;
+
+
+  if (ad_no_cost_var_fct)
+    p_ad->exhaustive = 1;
+
+
+  Alloc_Work_Arrays(p_ad->size);
+
+  if (p_ad->exhaustive)
+    p_ad->conflict_set = 0;
+
+  var_cost = NULL;		/* batch evaluation scans all vars: not if a Next_I restricts them */
+  if (!p_ad->exhaustive && !ad_no_cost_all_var_fct && ad_no_next_i_fct)
+    var_cost = work_var_cost;
+
   memset(mark, 0, p_ad->size * sizeof(unsigned)); /* init with 0 */
 
   int overall_best_cost = BIG;	/* this one is the best cost across restarts (best of best) */
   int *overall_best_sol = NULL;	/* this one is the best sol  across restarts (needed for optim_pb) */
 
-  if (p_ad->optim_pb)
+  if (p_ad->optim_pb || p_ad->restart_from_best)
     {
-      overall_best_sol = (int *) malloc(p_ad->size * sizeof(int));
-      if (overall_best_sol == NULL)
-	{
-	  fprintf(stderr, "%s:%d: malloc failed\n", __FILE__, __LINE__);
-	  exit(1);
-	}
+      overall_best_sol = work_best_sol;
       memcpy(overall_best_sol, p_ad->sol, p_ad->size * sizeof(int));      
     }
 
 #ifdef LOG_FILE
-  f_log = NULL;
+  trace_on = 0;
   if (p_ad->log_file)
-    if ((f_log = fopen(p_ad->log_file, "w")) == NULL)
-      perror(p_ad->log_file);
+    {
+      AdTraceHeader h;
+
+      h.size = p_ad->size;
+      h.seed = p_ad->seed;
+      h.exhaustive = p_ad->exhaustive;
+      trace_on = Ad_Trace_Open(&trace, p_ad->log_file, &h);
+    }
+#endif
+
+#ifdef PERF_COUNTERS
+  Perf_Init();
 #endif
 
+  if (p_ad->adaptive)
+    Adapt_Init();
+
   p_ad->nb_restart = -1;
 
   p_ad->nb_iter = 0;
@@ -539,6 +1027,8 @@ Ad_Solve(AdData *p_ad0)
     }
 #endif
 
+  Perf_Begin();
+
   if (!p_ad->do_not_init)
     {
     restart:
@@ -548,7 +1038,16 @@ Ad_Solve(AdData *p_ad0)
       p_ad->nb_reset_tot += p_ad->nb_reset;
       p_ad->nb_local_min_tot += p_ad->nb_local_min;
 
-      Set_Init_Configuration(p_ad);
+      if (p_ad->restart_from_best && p_ad->nb_restart >= 0)
+	{			/* perturbation of the best config (as a reset) */
+	  memcpy(p_ad->sol, overall_best_sol, p_ad->size * sizeof(int));
+	  Cost_Of_Solution(1);
+	  if (p_ad->conflict_set)
+	    Conflict_Rebuild();
+	  Reset(p_ad->nb_var_to_reset, p_ad);
+	}
+      else
+	Set_Init_Configuration(p_ad);
       memset(mark, 0, p_ad->size * sizeof(unsigned)); /* init with 0 */
     }
 
@@ -562,7 +1061,23 @@ Ad_Solve(AdData *p_ad0)
 
   nb_in_plateau = 0;
 
-  best_cost = p_ad->total_cost = Cost_Of_Solution(1);
+  restart_iter_limit = Restart_Limit(p_ad->nb_restart);
+  restart_iter_ref = 0;
+
+  if (p_ad->warm_start && p_ad->do_not_init && p_ad->nb_restart == 0 && p_ad->total_cost >= 0)
+    best_cost = p_ad->total_cost; /* warm start: the problem data are already up to date */
+  else
+    best_cost = p_ad->total_cost = Cost_Of_Solution(1);
+
+  if (p_ad->conflict_set)
+    Conflict_Rebuild();
+
+  if (p_ad->adaptive)
+    Adapt_Start();
+
+  Perf_End(AD_PHASE_RESTART);
+
+  Emit_Log(AD_TRACE_RESTART, p_ad->nb_restart, 0, 0, 0, 0);
 
   while(!TARGET_REACHED(p_ad))
     {
@@ -580,25 +1095,49 @@ Ad_Solve(AdData *p_ad0)
 
       p_ad->nb_iter++;
 
-      if (p_ad->nb_iter >= p_ad->restart_limit)
+      if (p_ad->adaptive && p_ad->nb_iter % adapt_window == 0)
+	Adapt_Parameters();
+
+      if (ad_report)
 	{
-	  if (p_ad->nb_restart < p_ad->restart_max)
-	    goto restart;
+	  ad_report = 0;
+	  if (ad_report_fct)
+	    (*ad_report_fct)(p_ad, (best_cost < overall_best_cost) ? best_cost : overall_best_cost);
+	}
+
+      if (p_ad->nb_iter - restart_iter_ref >= restart_iter_limit || ad_stop)
+	{
+	  if (p_ad->nb_restart < p_ad->restart_max && !ad_stop)
+	    {
+	      Perf_Begin();
+	      goto restart;
+	    }
 	  break;
 	}
 
       if (!p_ad->exhaustive)
 	{
+	  Perf_Begin();
 	  Select_Var_High_Cost();
+	  Perf_End(AD_PHASE_SELECT_VAR);
+	  if (max_i < 0)
+	    {
+	      Emit_Log(AD_TRACE_RESET, AD_TRACE_RESET_ALL_FROZEN, p_ad->nb_var_to_reset, 0, 0, 0);
+	      Do_Reset(p_ad->nb_var_to_reset);
+	      continue;
+	    }
+	  Perf_Begin();
 	  Select_Var_Min_Conflict();
+	  Perf_End(AD_PHASE_SELECT_SWAP);
 	}
       else
 	{
+	  Perf_Begin();
 	  Select_Vars_To_Swap();
+	  Perf_End(AD_PHASE_SELECT_SWAP);
 	}
 
-      Emit_Log("----- iter no: %d, cost: %d, nb marked: %d ---",
-	       p_ad->nb_iter, p_ad->total_cost, nb_var_marked);
+      Emit_Log(AD_TRACE_ITER, nb_var_marked, 0, 0, 0, 0);
       /*
 	printf("----- iter no: %d, cost: %d, nb marked: %d --- swap: %d/%d  nb pairs: %d  new cost: %d\n", 
 	p_ad->nb_iter, p_ad->total_cost, nb_var_marked,
@@ -619,26 +1158,28 @@ Ad_Solve(AdData *p_ad0)
 	{
 	  if (nb_in_plateau > 1)
 	    {
-	      Emit_Log("\tend of plateau, length: %d", nb_in_plateau);
+	      Emit_Log(AD_TRACE_END_PLATEAU, nb_in_plateau, 0, 0, 0, 0);
 	    }
 	  nb_in_plateau = 0;
 	}
+      else if (p_ad->adaptive)
+	adapt_nb_plateau++;
 
       if (new_cost < best_cost)
 	{
 	  best_cost = new_cost;
+	  if (p_ad->restart_policy == AD_RESTART_PROGRESS)
+	    restart_iter_ref = p_ad->nb_iter;
 	}
 
 
       if (!p_ad->exhaustive)
 	{
-	  Emit_Log("\tswap: %d/%d  nb max/min: %d/%d  new cost: %d",
-		   max_i, min_j, list_i_nb, list_j_nb, new_cost);
+	  Emit_Log(AD_TRACE_SWAP, max_i, min_j, list_i_nb, list_j_nb, new_cost);
 	}
       else
 	{
-	  Emit_Log("\tswap: %d/%d  nb pairs: %d  new cost: %d",
-		   max_i, min_j, list_ij_nb, new_cost);
+	  Emit_Log(AD_TRACE_SWAP, max_i, min_j, list_ij_nb, -1, new_cost);
 	}
 
 
@@ -650,7 +1191,7 @@ Ad_Solve(AdData *p_ad0)
 #if 0
       if (new_cost >= p_ad->total_cost && nb_in_plateau > 15)
 	{
-	  Emit_Log("\tTOO BIG PLATEAU - RESET");
+	  Emit_Log(AD_TRACE_RESET, AD_TRACE_RESET_PLATEAU, p_ad->nb_var_to_reset, 0, 0, 0);
 	  Do_Reset(p_ad->nb_var_to_reset);
 	}
 #endif
@@ -659,6 +1200,9 @@ Ad_Solve(AdData *p_ad0)
       if (min_j == -1)
 	continue;
 
+      if (p_ad->move_tries > 0 && new_cost >= p_ad->total_cost && Do_Compound_Move())
+	continue;
+
       if (max_i == min_j)
 	{
 	  p_ad->nb_local_min++;
@@ -666,7 +1210,7 @@ Ad_Solve(AdData *p_ad0)
 
 	  if (nb_var_marked + 1 >= p_ad->reset_limit)
 	    {
-	      Emit_Log("\tTOO MANY FROZEN VARS - RESET");
+	      Emit_Log(AD_TRACE_RESET, AD_TRACE_RESET_TOO_MANY, p_ad->nb_var_to_reset, 0, 0, 0);
 	      Do_Reset(p_ad->nb_var_to_reset);
 	    }
 	}
@@ -681,39 +1225,34 @@ Ad_Solve(AdData *p_ad0)
 	  else
 	    Mark(min_j, p_ad->freeze_swap);
 #endif
+	  Perf_Begin();
 	  Ad_Swap(max_i, min_j);
 	  p_ad->total_cost = new_cost;
 	  Executed_Swap(max_i, min_j);
+	  Perf_End(AD_PHASE_EXEC_SWAP);
+
+	  if (p_ad->conflict_set)
+	    {
+	      Ad_Conflict_Add(max_i);
+	      Ad_Conflict_Add(min_j);
+	    }
 	}
     }
 
 #ifdef LOG_FILE
-  if (f_log)
-    fclose(f_log);
-#endif
-
-  free(mark);
-  free(list_i);
-  if (!p_ad->exhaustive)
-    free(list_j);
-  else
-    free(list_ij);
-
-#if defined(DEBUG) && (DEBUG&1)
-  free(err_var);
-  free(swap);
+  if (trace_on)
+    Ad_Trace_Close(&trace);
 #endif
 
+  if (p_ad->adaptive)		/* give back the initial parameters */
+    Adapt_Start();
 
   if (overall_best_cost < p_ad->total_cost && overall_best_sol)
     {
       memcpy(p_ad->sol, overall_best_sol, p_ad->size * sizeof(int));
-      p_ad->total_cost = overall_best_cost;
+      p_ad->total_cost = Cost_Of_Solution(1); /* = overall_best_cost, and data up to date for a warm start */
     }
 
-  if (overall_best_sol)
-    free(overall_best_sol);
-
   p_ad->nb_iter_tot += p_ad->nb_iter; 
   p_ad->nb_swap_tot += p_ad->nb_swap; 
   p_ad->nb_same_var_tot += p_ad->nb_same_var;
@@ -725,6 +1264,150 @@ Ad_Solve(AdData *p_ad0)
 
 
 
+#ifdef PERF_COUNTERS
+
+/*
+ *  PERF_INIT
+ *
+ *  Opens the hardware counters (only once). They count user-level
+ *  events of the process, the engine only uses differences. The 4
+ *  counters are first opened as a group (read with one system call). If
+ *  not possible each counter is opened alone. An unavailable counter
+ *  (no support, perf_event_paranoid, not Linux...) is only reported
+ *  as such: the wall time per phase is always measured.
+ */
+static void
+Perf_Init(void)
+{
+  static int done = 0;
+  static int config[AD_NB_COUNTERS] = { -1, 
+#ifdef __linux__
+					PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+					PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+#endif
+  };
+  int k, nb_avail = 0;
+
+  if (done)
+    return;
+  done = 1;
+
+  ad_perf_avail[AD_CNT_NS] = 1;
+  for(k = 1; k < AD_NB_COUNTERS; k++)
+    perf_fd[k] = -1;
+
+#ifdef __linux__
+  struct perf_event_attr attr;
+  int try_group;
+
+  for(try_group = 1; try_group >= 0 && nb_avail < AD_NB_COUNTERS - 1; try_group--)
+    {
+      for(k = 1; k < AD_NB_COUNTERS; k++)
+	if (perf_fd[k] >= 0)
+	  close(perf_fd[k]);
+
+      nb_avail = 0;
+      for(k = 1; k < AD_NB_COUNTERS; k++)
+	{
+	  memset(&attr, 0, sizeof(attr));
+	  attr.size = sizeof(attr);
+	  attr.type = PERF_TYPE_HARDWARE;
+	  attr.config = config[k];
+	  attr.exclude_kernel = 1;
+	  attr.exclude_hv = 1;
+	  if (try_group)
+	    attr.read_format = PERF_FORMAT_GROUP;
+
+	  perf_fd[k] = syscall(__NR_perf_event_open, &attr, 0, -1,
+			       (try_group && k > 1) ? perf_fd[1] : -1, 0);
+	  if (perf_fd[k] >= 0)
+	    nb_avail++;
+	  else if (try_group)
+	    break;
+	}
+      perf_group = try_group;
+    }
+
+  if (perf_group && nb_avail < AD_NB_COUNTERS - 1) /* should not occur */
+    perf_group = 0;
+#endif
+
+  for(k = 1; k < AD_NB_COUNTERS; k++)
+    ad_perf_avail[k] = (perf_fd[k] >= 0);
+
+  if (nb_avail < AD_NB_COUNTERS - 1)
+    fprintf(stderr, "warning: %d hardware counters out of %d are available "
+	    "(only the time is measured for the others)\n", nb_avail, AD_NB_COUNTERS - 1);
+}
+
+
+
+
+/*
+ *  PERF_READ
+ *
+ *  Reads the current values of the counters. Returns 0 if the group of
+ *  counters could not be read (the values of the counters are then 0).
+ */
+static int
+Perf_Read(long long *val)
+{
+  int k;
+
+  val[AD_CNT_NS] = Real_Time_Ns();
+
+#ifdef __linux__
+  if (perf_group)
+    {
+      long long buff[1 + AD_NB_COUNTERS - 1]; /* nr followed by the values */
+
+      if (read(perf_fd[1], buff, sizeof(buff)) != sizeof(buff))
+	{
+	  memset(val + 1, 0, (AD_NB_COUNTERS - 1) * sizeof(long long));
+	  return 0;
+	}
+      for(k = 1; k < AD_NB_COUNTERS; k++)
+	val[k] = buff[k];
+      return 1;
+    }
+
+  for(k = 1; k < AD_NB_COUNTERS; k++)
+    if (perf_fd[k] < 0 || read(perf_fd[k], &val[k], sizeof(val[k])) != sizeof(val[k]))
+      val[k] = 0;
+#else
+  for(k = 1; k < AD_NB_COUNTERS; k++)
+    val[k] = 0;
+#endif
+
+  return 1;
+}
+
+
+
+
+/*
+ *  PERF_ADD
+ *
+ *  Adds the counts since the last Perf_Begin to a phase.
+ */
+static void
+Perf_Add(int phase)
+{
+  long long now[AD_NB_COUNTERS];
+  int k, nb = AD_NB_COUNTERS;
+
+  if (!Perf_Read(now) || !perf_start_ok) /* only the time is valid */
+    nb = AD_CNT_NS + 1;
+  ad_perf[phase].nb_calls++;
+  for(k = 0; k < nb; k++)
+    ad_perf[phase].val[k] += now[k] - perf_start[k];
+}
+
+#endif /* PERF_COUNTERS */
+
+
+
+
 /*
  *  AD_DISPLAY
  *
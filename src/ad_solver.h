@@ -23,6 +23,12 @@
  * Constants *
  *-----------*/
 
+				/* restart policies (restart_policy) */
+#define AD_RESTART_FIXED      0	/* restart every restart_limit iters */
+#define AD_RESTART_LUBY       1	/* restart_limit * Luby sequence 1 1 2 1 1 2 4 1 1 2 ... */
+#define AD_RESTART_GEOMETRIC  2	/* restart_limit * (1 + restart_grow/100)^k for the kth run */
+#define AD_RESTART_PROGRESS   3	/* restart after restart_limit iters without a better cost */
+
 /*-------*
  * Types *
  *-------*/
@@ -33,6 +39,8 @@ typedef struct
 
   int size;			/* nb of variables */
   int do_not_init;		/* use the initial solution (else random permut) */
+  int warm_start;		/* with do_not_init: the data of the problem are up to date for sol
+				   (e.g. after Apply_Delta) and total_cost is its cost (or -1) */
   int *actual_value;		/* if random permut: actual values (see tools.c) */
   int base_value;		/* if random permut: base value (see tools.c) */
   int debug;			/* debug level (0 1 2) */
@@ -43,6 +51,9 @@ typedef struct
 
   int exhaustive;		/* perform an exhausitve search */
   int first_best;		/* stop as soon as a better swap is found */
+  int conflict_set;		/* select max var among a set of vars in conflict (see Ad_Conflict_Add) */
+  int move_tries;		/* nb of compound moves tried when no swap improves (see Cost_If_Move) */
+  int adaptive;			/* adapt freeze/reset parameters during the run */
   int prob_select_loc_min;	/* % to select local min instead of staying on a plateau (or >100 to not use)*/
   int freeze_loc_min;		/* nb swaps to freeze a (local min) var */
   int freeze_swap;		/* nb swaps to freeze 2 swapped vars */
@@ -50,6 +61,9 @@ typedef struct
   int nb_var_to_reset;		/* nb variables to reset */
   int restart_limit;		/* nb of iterations before restart */
   int restart_max;		/* max nb of times to restart (to retry) */
+  int restart_policy;		/* how restart_limit evolves (AD_RESTART_xxx) */
+  int restart_grow;		/* AD_RESTART_GEOMETRIC: % of growth at each restart */
+  int restart_from_best;	/* restart from (a perturbation of) the best config, not a random one */
   int reinit_after_if_swap;	/* true if Cost_Of_Solution must be called twice */
   int optim_pb;			/* optimization pb ? if yes save the best solution when found */
   int target_cost;		/* target cost to reach (either exactly or better) */
@@ -96,10 +110,23 @@ typedef struct
  *------------------*/
 
 int *ad_sol ALIGN;		/* copy of p_ad->sol (used by no_cost_swap) */
+
+int *ad_conflict;		/* vars (maybe) in conflict (if p_ad->conflict_set) */
+int ad_nb_conflict;		/* nb of elements of ad_conflict[] */
 int ad_reinit_after_if_swap;	/* copy of p_ad->reinit_after_if_swap (used by no_cost_swap) */
 
 int ad_no_cost_var_fct;		/* true if a user Cost_On_Variable is not defined */
+int ad_no_cost_all_var_fct;	/* true if a user Cost_On_All_Variables is not defined */
+int ad_no_next_i_fct;		/* true if a user Next_I is not defined */
+int ad_no_next_j_fct;		/* true if a user Next_J is not defined */
 int ad_no_displ_sol_fct;	/* true if a user Display_Sol is not defined */
+int ad_no_free_pb_fct;		/* true if a user Free_Problem is not defined */
+int ad_no_apply_delta_fct;	/* true if a user Apply_Delta is not defined */
+int ad_no_select_pb_fct;	/* true if Select_Problem is not defined (not adsolve) */
+
+volatile int ad_stop;		/* set (e.g. by a signal handler) to stop Ad_Solve asap */
+volatile int ad_report;		/* set (e.g. by a timer) to call ad_report_fct asap */
+void (*ad_report_fct)(AdData *p_ad, int best_cost); /* progress report (or NULL) */
 
 
 
@@ -117,6 +144,37 @@ int ad_has_log_file;
 #endif
 
 
+				/* counters per phase of the engine (compiled with PERF_COUNTERS) */
+#define AD_PHASE_SELECT_VAR    0	/* Select_Var_High_Cost */
+#define AD_PHASE_SELECT_SWAP   1	/* Select_Var_Min_Conflict / Select_Vars_To_Swap */
+#define AD_PHASE_EXEC_SWAP     2	/* Ad_Swap + Executed_Swap */
+#define AD_PHASE_RESET         3	/* Do_Reset */
+#define AD_PHASE_RESTART       4	/* (re)start: initial configuration + cost */
+#define AD_NB_PHASES           5
+
+#define AD_CNT_NS              0	/* wall time in nsecs (always available) */
+#define AD_CNT_CYCLES          1	/* hardware counters (perf_event_open) */
+#define AD_CNT_INSTR           2
+#define AD_CNT_CACHE_MISS      3
+#define AD_CNT_BRANCH_MISS     4
+#define AD_NB_COUNTERS         5
+
+typedef struct
+{
+  long long nb_calls;
+  long long val[AD_NB_COUNTERS];
+} AdPerfPhase;
+
+AdPerfPhase ad_perf[AD_NB_PHASES]; /* cumulated over all calls to Ad_Solve */
+int ad_perf_avail[AD_NB_COUNTERS]; /* is a counter available (set by Ad_Solve) */
+
+#if defined(AD_SOLVER_FILE) && defined(PERF_COUNTERS)
+int ad_has_perf = 1;
+#else
+int ad_has_perf;
+#endif
+
+
 /*------------*
  * Prototypes *
  *------------*/
@@ -127,6 +185,8 @@ void Ad_Swap(int i, int j);
 
 void Ad_Un_Mark(int i);
 
+void Ad_Conflict_Add(int i);
+
 void Ad_Display(int *t, AdData *p_ad, unsigned *mark);
 
 							/* functions provided by the user */
@@ -139,8 +199,12 @@ int Cost_Of_Solution(int should_be_recorded);		/* mandatory */
 
 int Cost_On_Variable(int i);				/* optional else exhaustive search */
 
+void Cost_On_All_Variables(int *err);			/* optional else Cost_On_Variable on each var */
+
 int Cost_If_Swap(int current_cost, int i, int j);	/* optional else use Cost_Of_Solution */
 
+int Cost_If_Move(int current_cost, int *var, int nb_var); /* optional else use Cost_Of_Solution */
+
 void Executed_Swap(int i, int j); 			/* optional else use Cost_Of_Solution */
 
 int Next_I(int i);					/* optional else from 0 to p_ad->size-1 */
@@ -151,6 +215,14 @@ int Reset(int nb_to_reset, AdData *p_ad);		/* optional else random reset */
 
 void Display_Solution(AdData *p_ad);			/* optional else basic display */
 
+void Free_Problem(AdData *p_ad);			/* optional: forget the instance (server mode) */
+
+int Apply_Delta(AdData *p_ad, char *delta);		/* optional: modify the instance (server mode) */
+
+							/* provided by adsolve (see ad_problem.h) */
+
+char *Select_Problem(char *name);			/* select a problem, returns its name (or NULL) */
+
 
 
 #define TARGET_REACHED(p) \
@@ -0,0 +1,22 @@
+/*
+ *  Adaptive search
+ *
+ *  Copyright (C) 2002-2011 Daniel Diaz, Philippe Codognet and Salvador Abreu
+ *
+ *  ad_specialize.c: the engine specialized for a bench (make BENCH-spec)
+ *
+ *  Compiled with -DAD_BENCH=\"bench.c\": the bench and the engine are one
+ *  translation unit, so the compiler can inline the user functions
+ *  (Cost_On_Variable, Cost_If_Swap, Next_J...) in the selection loops
+ *  of Ad_Solve. The rest (main.c, no_xxx.c wrappers...) comes from
+ *  libad_solver.a as for the bench (ad_solver.o is not linked).
+ *
+ *  The gain needs an optimizing CFLAGS (e.g. -O3) and is significant for
+ *  benches whose user functions are light (queens, magic-square...).
+ */
+
+#define AD_SOLVER_FILE		/* the bench includes ad_solver.h first */
+
+#include AD_BENCH
+
+#include "ad_solver.c"
@@ -0,0 +1,166 @@
+/*
+ *  Adaptive search
+ *
+ *  Copyright (C) 2002-2011 Daniel Diaz, Philippe Codognet and Salvador Abreu
+ *
+ *  ad_trace.c: binary trace of the search (log file)
+ *
+ *  The solver puts fixed-size records in a ring buffer (no lock, no
+ *  system call). A writer thread drains the ring to the file by large
+ *  blocks. Use adtrace to decode a trace (text or CSV).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+
+#include "ad_trace.h"
+
+/*-----------*
+ * Constants *
+ *-----------*/
+
+#define WRITER_SLEEP_NS  200000	/* writer sleep when the ring is empty */
+
+/*-------*
+ * Types *
+ *-------*/
+
+/*------------------*
+ * Global variables *
+ *------------------*/
+
+/*------------*
+ * Prototypes *
+ *------------*/
+
+static void *Writer(void *arg);
+
+
+
+
+/*
+ *  AD_TRACE_OPEN
+ *
+ *  Creates the file, writes the header and starts the writer thread.
+ *  Returns 0 on error.
+ */
+int
+Ad_Trace_Open(AdTrace *t, const char *file_name, AdTraceHeader *h)
+{
+  memcpy(h->magic, AD_TRACE_MAGIC, 4);
+  h->version = AD_TRACE_VERSION;
+  h->rec_size = sizeof(AdTraceRec);
+
+  t->head = t->tail = 0;
+  t->stop = 0;
+  t->nb_wait = 0;
+
+  if ((t->f = fopen(file_name, "wb")) == NULL)
+    {
+      perror(file_name);
+      return 0;
+    }
+
+  t->ring = (AdTraceRec *) malloc(AD_TRACE_RING_SIZE * sizeof(AdTraceRec));
+  if (t->ring == NULL)
+    {
+      fprintf(stderr, "%s:%d malloc failed\n", __FILE__, __LINE__);
+      exit(1);
+    }
+
+  fwrite(h, sizeof(*h), 1, t->f);
+
+  if (pthread_create(&t->writer, NULL, Writer, t) != 0)
+    {
+      perror("pthread_create");
+      fclose(t->f);
+      free(t->ring);
+      return 0;
+    }
+
+  return 1;
+}
+
+
+
+
+/*
+ *  AD_TRACE_CLOSE
+ *
+ *  Stops the writer (once the ring is drained) and closes the file.
+ */
+void
+Ad_Trace_Close(AdTrace *t)
+{
+  __atomic_store_n(&t->stop, 1, __ATOMIC_RELEASE);
+  pthread_join(t->writer, NULL);
+
+  fclose(t->f);
+  free(t->ring);
+
+  if (t->nb_wait > 0)
+    fprintf(stderr, "trace: the solver waited %lld times for the writer (ring full)\n",
+	    t->nb_wait);
+}
+
+
+
+
+/*
+ *  AD_TRACE_WAIT
+ *
+ *  Called by Ad_Trace_Put when the ring is full.
+ */
+void
+Ad_Trace_Wait(AdTrace *t)
+{
+  t->nb_wait++;
+  while(t->head - __atomic_load_n(&t->tail, __ATOMIC_ACQUIRE) >= AD_TRACE_RING_SIZE)
+    sched_yield();
+}
+
+
+
+
+/*
+ *  WRITER
+ *
+ *  The writer thread: writes the records between tail and head (by
+ *  contiguous blocks of the ring).
+ */
+static void *
+Writer(void *arg)
+{
+  AdTrace *t = (AdTrace *) arg;
+  struct timespec ts = { 0, WRITER_SLEEP_NS };
+  unsigned head, tail, beg, nb;
+  int stop;
+
+  for(;;)
+    {
+      stop = __atomic_load_n(&t->stop, __ATOMIC_ACQUIRE); /* before head: no record lost */
+      head = __atomic_load_n(&t->head, __ATOMIC_ACQUIRE);
+      tail = t->tail;
+
+      if (head == tail)
+	{
+	  if (stop)
+	    break;
+	  nanosleep(&ts, NULL);
+	  continue;
+	}
+
+      beg = tail & (AD_TRACE_RING_SIZE - 1);
+      nb = head - tail;
+      if (nb > AD_TRACE_RING_SIZE - beg)	/* until the end of the ring */
+	nb = AD_TRACE_RING_SIZE - beg;
+
+      fwrite(t->ring + beg, sizeof(AdTraceRec), nb, t->f);
+      __atomic_store_n(&t->tail, tail + nb, __ATOMIC_RELEASE);
+    }
+
+  return NULL;
+}
@@ -0,0 +1,116 @@
+/*
+ *  Adaptive search
+ *
+ *  Copyright (C) 2002-2011 Daniel Diaz, Philippe Codognet and Salvador Abreu
+ *
+ *  ad_trace.h: binary trace of the search (log file) - header file
+ */
+
+#ifndef _AD_TRACE_H
+#define _AD_TRACE_H
+
+#include <stdio.h>
+#include <pthread.h>
+
+/*-----------*
+ * Constants *
+ *-----------*/
+
+#define AD_TRACE_MAGIC         "ADTR"
+#define AD_TRACE_VERSION       1
+
+#define AD_TRACE_RING_SIZE     (1 << 16) /* nb of records (a power of 2) */
+
+				/* events */
+#define AD_TRACE_RESTART       0	/* v0=restart no */
+#define AD_TRACE_ITER          1	/* v0=nb marked vars */
+#define AD_TRACE_SWAP          2	/* v0=max_i v1=min_j v2=nb max (or pairs) v3=nb min (-1 if exhaustive) v4=new cost */
+#define AD_TRACE_END_PLATEAU   3	/* v0=length */
+#define AD_TRACE_RESET         4	/* v0=reason (AD_TRACE_RESET_xxx) v1=nb vars to reset */
+#define AD_TRACE_MOVE          5	/* v0..v3=vars of the 2 swaps v4=new cost */
+#define AD_TRACE_NB_EVENTS     6
+
+#define AD_TRACE_RESET_ALL_FROZEN   0
+#define AD_TRACE_RESET_TOO_MANY     1
+#define AD_TRACE_RESET_PLATEAU      2
+
+/*-------*
+ * Types *
+ *-------*/
+
+typedef struct			/* at the beginning of the file */
+{
+  char magic[4];		/* AD_TRACE_MAGIC */
+  int version;			/* AD_TRACE_VERSION */
+  int rec_size;			/* sizeof(AdTraceRec) */
+  int size;			/* problem size */
+  int seed;			/* seed of the run */
+  int exhaustive;		/* exhaustive search ? */
+} AdTraceHeader;
+
+
+typedef struct			/* one event (fixed size) */
+{
+  int type;			/* AD_TRACE_xxx */
+  int iter;			/* nb_iter when the event occurred */
+  int cost;			/* total_cost when the event occurred */
+  int v[5];			/* event dependent values */
+} AdTraceRec;
+
+
+typedef struct			/* a ring buffer drained by a writer thread */
+{
+  AdTraceRec *ring;		/* [AD_TRACE_RING_SIZE] */
+  unsigned head;		/* next record to fill (only written by the solver) */
+  unsigned tail;		/* next record to write (only written by the writer) */
+  int stop;			/* set by Ad_Trace_Close */
+  long long nb_wait;		/* nb of times the solver waited (ring full) */
+  FILE *f;
+  pthread_t writer;
+} AdTrace;
+
+/*------------------*
+ * Global variables *
+ *------------------*/
+
+/*------------*
+ * Prototypes *
+ *------------*/
+
+int Ad_Trace_Open(AdTrace *t, const char *file_name, AdTraceHeader *h);
+
+void Ad_Trace_Close(AdTrace *t);
+
+void Ad_Trace_Wait(AdTrace *t);
+
+
+
+/*
+ *  AD_TRACE_PUT
+ *
+ *  Adds an event in the ring (single producer, no lock). Only waits if
+ *  the ring is full (the writer is late).
+ */
+static inline void
+Ad_Trace_Put(AdTrace *t, int type, int iter, int cost, int v0, int v1, int v2, int v3, int v4)
+{
+  unsigned h = t->head;
+  AdTraceRec *r;
+
+  if (h - __atomic_load_n(&t->tail, __ATOMIC_ACQUIRE) >= AD_TRACE_RING_SIZE)
+    Ad_Trace_Wait(t);
+
+  r = t->ring + (h & (AD_TRACE_RING_SIZE - 1));
+  r->type = type;
+  r->iter = iter;
+  r->cost = cost;
+  r->v[0] = v0;
+  r->v[1] = v1;
+  r->v[2] = v2;
+  r->v[3] = v3;
+  r->v[4] = v4;
+
+  __atomic_store_n(&t->head, h + 1, __ATOMIC_RELEASE);
+}
+
+#endif /* _AD_TRACE_H */
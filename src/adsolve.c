@@ -0,0 +1,539 @@
+/*
+ *  Adaptive search
+ *
+ *  Copyright (C) 2002-2011 Daniel Diaz, Philippe Codognet and Salvador Abreu
+ *
+ *  adsolve.c: all the problems in one executable (registry and plugins)
+ *
+ *  Usage: adsolve PROBLEM [ OPTION ]... [ PARAM ]
+ *
+ *  PROBLEM is a built-in problem (the benches of this directory) or a
+ *  plugin: NAME (NAME.so is searched as by dlopen, e.g. LD_LIBRARY_PATH)
+ *  or a path to NAME.so (built with make NAME.so, see ad_problem.h).
+ *  The options and the parameter are those of the bench (see main.c).
+ *
+ *  In server mode (--serve) a request can change the problem (see
+ *  Serve_Stream in main.c): a worker hosts several problems.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dlfcn.h>
+
+#include "ad_problem.h"
+
+
+/*-----------*
+ * Constants *
+ *-----------*/
+
+#define MAX_PLUGINS                64
+
+/*-------*
+ * Types *
+ *-------*/
+
+typedef struct
+{
+  char *name;			/* as given to Select_Problem */
+  AdProblem *pb;
+} Plugin;
+
+/*------------------*
+ * Global variables *
+ *------------------*/
+
+extern AdProblem ad_problem_magic_square, ad_problem_queens, ad_problem_alpha;
+extern AdProblem ad_problem_all_interval, ad_problem_partit, ad_problem_langford;
+extern AdProblem ad_problem_langford3, ad_problem_skolem, ad_problem_skolem3;
+extern AdProblem ad_problem_perfect_square, ad_problem_costas, ad_problem_qap;
+extern AdProblem ad_problem_smti, ad_problem_linear, ad_problem_quasigroup;
+
+static AdProblem *builtin[] = {	/* PROBLEMS of the Makefile */
+  &ad_problem_magic_square, &ad_problem_queens, &ad_problem_alpha,
+  &ad_problem_all_interval, &ad_problem_partit, &ad_problem_langford,
+  &ad_problem_langford3, &ad_problem_skolem, &ad_problem_skolem3,
+  &ad_problem_perfect_square, &ad_problem_costas, &ad_problem_qap,
+  &ad_problem_smti, &ad_problem_linear, &ad_problem_quasigroup,
+  NULL
+};
+
+static Plugin plugin[MAX_PLUGINS]; /* loaded plugins (never unloaded) */
+static int nb_plugins;
+
+static AdProblem cur;		/* the selected problem (defaults for missing functions) */
+
+int param_needed;		/* variables of main.c (copied from the selected problem) */
+extern char *user_stat_name;
+extern int (*user_stat_fct)(AdData *p_ad);
+
+
+/*------------*
+ * Prototypes *
+ *------------*/
+
+static AdProblem *Load_Plugin(char *name);
+
+static void Set_Problem(AdProblem *pb);
+
+static void Display_Problems(void);
+
+
+
+
+/*
+ *  SELECT_PROBLEM
+ *
+ *  Selects the problem name (built-in or plugin). Returns its name or
+ *  NULL (error or list of the problems displayed).
+ *  The instance of the previous problem must have been freed
+ *  (Free_Problem) if it is not used again.
+ */
+char *
+Select_Problem(char *name)
+{
+  AdProblem *pb = NULL;
+  int i;
+
+  if (name == NULL || *name == '-')
+    {
+      Display_Problems();
+      return NULL;
+    }
+
+  for(i = 0; builtin[i] && pb == NULL; i++)
+    if (strcmp(builtin[i]->name, name) == 0)
+      pb = builtin[i];
+
+  if (pb == NULL && (pb = Load_Plugin(name)) == NULL)
+    return NULL;
+
+  Set_Problem(pb);
+  return pb->name;
+}
+
+
+
+
+/*
+ *  LOAD_PLUGIN
+ *
+ *  Loads NAME.so (or the path name if it ends with .so) and returns its
+ *  descriptor ad_problem_NAME ('-' replaced by '_').
+ */
+static AdProblem *
+Load_Plugin(char *name)
+{
+  char path[1024], sym[1024 + 16];
+  char *base, *p;
+  void *handle;
+  AdProblem *pb;
+  int i;
+
+  for(i = 0; i < nb_plugins; i++)
+    if (strcmp(plugin[i].name, name) == 0 || strcmp(plugin[i].pb->name, name) == 0)
+      return plugin[i].pb;
+
+  if (nb_plugins >= MAX_PLUGINS || strlen(name) + 4 >= sizeof(path))
+    {
+      fprintf(stderr, "cannot load %s: too many plugins or too long name\n", name);
+      return NULL;
+    }
+
+  strcpy(path, name);
+  p = path + strlen(path);
+  if (p - path < 3 || strcmp(p - 3, ".so") != 0)
+    strcpy(p, ".so");
+
+  base = strrchr(path, '/');
+  base = (base) ? base + 1 : path;
+  sprintf(sym, "ad_problem_%s", base);
+  sym[strlen(sym) - 3] = '\0';	/* remove .so */
+  for(p = sym; *p; p++)
+    if (*p == '-')
+      *p = '_';
+
+  if ((handle = dlopen(path, RTLD_NOW | RTLD_LOCAL)) == NULL)
+    {
+      fprintf(stderr, "unknown problem %s (%s)\n", name, dlerror());
+      return NULL;
+    }
+
+  if ((pb = (AdProblem *) dlsym(handle, sym)) == NULL)
+    {
+      fprintf(stderr, "%s is not a problem plugin (no %s)\n", path, sym);
+      dlclose(handle);
+      return NULL;
+    }
+
+  if (pb->name == NULL || pb->init_parameters == NULL || pb->solve == NULL ||
+      pb->check_solution == NULL || pb->cost_of_solution == NULL)
+    {
+      fprintf(stderr, "%s: incomplete problem descriptor %s\n", path, sym);
+      dlclose(handle);
+      return NULL;
+    }
+
+  if ((plugin[nb_plugins].name = strdup(name)) == NULL)
+    {
+      fprintf(stderr, "%s:%d malloc failed\n", __FILE__, __LINE__);
+      exit(1);
+    }
+  plugin[nb_plugins++].pb = pb;
+
+  return pb;
+}
+
+
+
+
+/*
+ *  DISPLAY_PROBLEMS
+ *
+ */
+static void
+Display_Problems(void)
+{
+  int i;
+
+  fprintf(stderr, "Usage: adsolve PROBLEM [ OPTION ]... [ PARAM ]\n\n");
+  fprintf(stderr, "built-in problems:");
+  for(i = 0; builtin[i]; i++)
+    fprintf(stderr, " %s", builtin[i]->name);
+  fprintf(stderr, "\nor a plugin: NAME (loads NAME.so) or a path to NAME.so\n");
+  fprintf(stderr, "use adsolve PROBLEM -h for the options\n");
+}
+
+
+
+
+/*
+ *  Defaults for the optional functions (same as no_xxx.c)
+ */
+
+static void
+Default_Set_Init_Configuration(AdData *p_ad)
+{
+  Random_Permut(p_ad->sol, p_ad->size, p_ad->actual_value, p_ad->base_value);
+}
+
+
+static void
+Default_Check_Init_Configuration(AdData *p_ad)
+{
+  int i = Random_Permut_Check(p_ad->sol, p_ad->size, p_ad->actual_value, p_ad->base_value);
+
+  if (i >= 0)
+    {
+      fprintf(stderr, "not a valid permutation, error at [%d] = %d\n", i, p_ad->sol[i]);
+      Random_Permut_Repair(p_ad->sol, p_ad->size, p_ad->actual_value, p_ad->base_value);
+      printf("possible repair:\n");
+      Display_Solution(p_ad);
+      exit(1);
+    }
+}
+
+
+static int
+Default_Cost_On_Variable(int i)	/* not called (ad_no_cost_var_fct) */
+{
+  return 0;
+}
+
+
+static void
+Default_Cost_On_All_Variables(int *err) /* not called (ad_no_cost_all_var_fct) */
+{
+}
+
+
+static int
+Default_Cost_If_Swap(int current_cost, int i, int j)
+{
+  int x;
+  int r;
+
+  x = ad_sol[i];
+  ad_sol[i] = ad_sol[j];
+  ad_sol[j] = x;
+
+  r = Cost_Of_Solution(0);
+
+  ad_sol[j] = ad_sol[i];
+  ad_sol[i] = x;
+
+  if (ad_reinit_after_if_swap)
+    Cost_Of_Solution(0);
+
+  return r;
+}
+
+
+static int
+Default_Cost_If_Move(int current_cost, int *var, int nb_var)
+{
+  int k, x;
+  int r;
+
+  for(k = 0; k < nb_var; k += 2)
+    {
+      x = ad_sol[var[k]];
+      ad_sol[var[k]] = ad_sol[var[k + 1]];
+      ad_sol[var[k + 1]] = x;
+    }
+
+  r = Cost_Of_Solution(0);
+
+  for(k = nb_var - 2; k >= 0; k -= 2)
+    {
+      x = ad_sol[var[k]];
+      ad_sol[var[k]] = ad_sol[var[k + 1]];
+      ad_sol[var[k + 1]] = x;
+    }
+
+  if (ad_reinit_after_if_swap)
+    Cost_Of_Solution(0);
+
+  return r;
+}
+
+
+static void
+Default_Executed_Swap(int i, int j)
+{
+}
+
+
+static int
+Default_Next_I(int i)
+{
+  return i + 1;
+}
+
+
+static int
+Default_Next_J(int i, int j, int exhaustive)
+{
+  if (j < 0 && exhaustive)
+    j = i;
+
+  return j + 1;
+}
+
+
+static int
+Default_Reset(int n, AdData *p_ad)
+{
+  int i, j, x;
+  int size = p_ad->size;
+  int *sol = p_ad->sol;
+
+  while(n--)
+    {
+      i = Random(size);
+      j = Random(size);
+
+      p_ad->nb_swap++;
+
+      x = sol[i];
+      sol[i] = sol[j];
+      sol[j] = x;
+
+#if UNMARK_AT_RESET == 1
+      Ad_Un_Mark(i);
+      Ad_Un_Mark(j);
+#endif
+    }
+
+  return -1;
+}
+
+
+static void
+Default_Display_Solution(AdData *p_ad)
+{
+  Ad_Display(p_ad->sol, p_ad, NULL);
+}
+
+
+static void
+Default_Free_Problem(AdData *p_ad)
+{
+}
+
+
+static int
+Default_Apply_Delta(AdData *p_ad, char *delta) /* not called (ad_no_apply_delta_fct) */
+{
+  return -2;
+}
+
+
+
+
+/*
+ *  SET_PROBLEM
+ *
+ *  Makes pb the current problem. A missing optional function (NULL or
+ *  the forwarder of adsolve, see ad_problem.h) is replaced by its default.
+ */
+
+#define Set_Opt(f, fwd, dflt)  cur.f = (pb->f == NULL || pb->f == fwd) ? dflt : pb->f
+
+static void
+Set_Problem(AdProblem *pb)
+{
+  cur = *pb;
+
+  Set_Opt(set_init_configuration, Set_Init_Configuration, Default_Set_Init_Configuration);
+  Set_Opt(check_init_configuration, Check_Init_Configuration, Default_Check_Init_Configuration);
+  Set_Opt(cost_on_variable, Cost_On_Variable, Default_Cost_On_Variable);
+  Set_Opt(cost_on_all_variables, Cost_On_All_Variables, Default_Cost_On_All_Variables);
+  Set_Opt(cost_if_swap, Cost_If_Swap, Default_Cost_If_Swap);
+  Set_Opt(cost_if_move, Cost_If_Move, Default_Cost_If_Move);
+  Set_Opt(executed_swap, Executed_Swap, Default_Executed_Swap);
+  Set_Opt(next_i, Next_I, Default_Next_I);
+  Set_Opt(next_j, Next_J, Default_Next_J);
+  Set_Opt(reset, Reset, Default_Reset);
+  Set_Opt(display_solution, Display_Solution, Default_Display_Solution);
+  Set_Opt(free_problem, Free_Problem, Default_Free_Problem);
+  Set_Opt(apply_delta, Apply_Delta, Default_Apply_Delta);
+
+  ad_no_cost_var_fct = (cur.cost_on_variable == Default_Cost_On_Variable);
+  ad_no_cost_all_var_fct = (cur.cost_on_all_variables == Default_Cost_On_All_Variables);
+  ad_no_next_i_fct = (cur.next_i == Default_Next_I);
+  ad_no_next_j_fct = (cur.next_j == Default_Next_J);
+  ad_no_displ_sol_fct = (cur.display_solution == Default_Display_Solution);
+  ad_no_free_pb_fct = (cur.free_problem == Default_Free_Problem);
+  ad_no_apply_delta_fct = (cur.apply_delta == Default_Apply_Delta);
+
+  param_needed = (pb->param_needed) ? *pb->param_needed : 0;
+  user_stat_name = (pb->user_stat_name) ? *pb->user_stat_name : NULL;
+  user_stat_fct = (pb->user_stat_fct) ? *pb->user_stat_fct : NULL;
+}
+
+
+
+
+/*
+ *  Forwarders: the user functions called by the engine and main.c
+ */
+
+void
+Init_Parameters(AdData *p_ad)
+{
+  (*cur.init_parameters)(p_ad);
+}
+
+
+void
+Solve(AdData *p_ad)
+{
+  (*cur.solve)(p_ad);
+}
+
+
+int
+Check_Solution(AdData *p_ad)
+{
+  return (*cur.check_solution)(p_ad);
+}
+
+
+int
+Cost_Of_Solution(int should_be_recorded)
+{
+  return (*cur.cost_of_solution)(should_be_recorded);
+}
+
+
+void
+Set_Init_Configuration(AdData *p_ad)
+{
+  (*cur.set_init_configuration)(p_ad);
+}
+
+
+void
+Check_Init_Configuration(AdData *p_ad)
+{
+  (*cur.check_init_configuration)(p_ad);
+}
+
+
+int
+Cost_On_Variable(int i)
+{
+  return (*cur.cost_on_variable)(i);
+}
+
+
+void
+Cost_On_All_Variables(int *err)
+{
+  (*cur.cost_on_all_variables)(err);
+}
+
+
+int
+Cost_If_Swap(int current_cost, int i, int j)
+{
+  return (*cur.cost_if_swap)(current_cost, i, j);
+}
+
+
+int
+Cost_If_Move(int current_cost, int *var, int nb_var)
+{
+  return (*cur.cost_if_move)(current_cost, var, nb_var);
+}
+
+
+void
+Executed_Swap(int i, int j)
+{
+  (*cur.executed_swap)(i, j);
+}
+
+
+int
+Next_I(int i)
+{
+  return (*cur.next_i)(i);
+}
+
+
+int
+Next_J(int i, int j, int exhaustive)
+{
+  return (*cur.next_j)(i, j, exhaustive);
+}
+
+
+int
+Reset(int nb_to_reset, AdData *p_ad)
+{
+  return (*cur.reset)(nb_to_reset, p_ad);
+}
+
+
+void
+Display_Solution(AdData *p_ad)
+{
+  (*cur.display_solution)(p_ad);
+}
+
+
+void
+Free_Problem(AdData *p_ad)
+{
+  (*cur.free_problem)(p_ad);
+}
+
+
+int
+Apply_Delta(AdData *p_ad, char *delta)
+{
+  return (*cur.apply_delta)(p_ad, delta);
+}
@@ -0,0 +1,158 @@
+/*
+ *  Adaptive search
+ *
+ *  Copyright (C) 2002-2011 Daniel Diaz, Philippe Codognet and Salvador Abreu
+ *
+ *  adtrace.c: decoder of the binary trace of the search (log file)
+ *
+ *  Usage: adtrace [-c] FILE
+ *
+ *  Displays the trace as text (same lines as the old text log) or as CSV
+ *  (-c: one line per event).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ad_trace.h"
+
+/*-----------*
+ * Constants *
+ *-----------*/
+
+/*-------*
+ * Types *
+ *-------*/
+
+/*------------------*
+ * Global variables *
+ *------------------*/
+
+static char *event_name[AD_TRACE_NB_EVENTS] = {
+  "restart", "iter", "swap", "end_plateau", "reset", "move"
+};
+
+static char *reset_msg[] = {
+  "ALL VARS FROZEN", "TOO MANY FROZEN VARS", "TOO BIG PLATEAU"
+};
+
+/*------------*
+ * Prototypes *
+ *------------*/
+
+static void Display_Text(AdTraceRec *r, int exhaustive);
+
+
+
+
+int
+main(int argc, char *argv[])
+{
+  AdTraceHeader h;
+  AdTraceRec r;
+  FILE *f;
+  int csv = 0;
+  int i = 1;
+
+  if (i < argc && strcmp(argv[i], "-c") == 0)
+    {
+      csv = 1;
+      i++;
+    }
+
+  if (i != argc - 1 || argv[i][0] == '-')
+    {
+      fprintf(stderr, "Usage: %s [-c] FILE\n", argv[0]);
+      fprintf(stderr, "   -c          output in CSV (else text)\n");
+      return 1;
+    }
+
+  if ((f = fopen(argv[i], "rb")) == NULL)
+    {
+      perror(argv[i]);
+      return 1;
+    }
+
+  if (fread(&h, sizeof(h), 1, f) != 1 || memcmp(h.magic, AD_TRACE_MAGIC, 4) != 0)
+    {
+      fprintf(stderr, "%s: not a trace file\n", argv[i]);
+      return 1;
+    }
+
+  if (h.version != AD_TRACE_VERSION || h.rec_size != sizeof(AdTraceRec))
+    {
+      fprintf(stderr, "%s: unsupported trace version %d (record size: %d)\n",
+	      argv[i], h.version, h.rec_size);
+      return 1;
+    }
+
+  if (csv)
+    printf("event,iter,cost,v0,v1,v2,v3,v4\n");
+  else
+    printf("size: %d  seed: %d%s\n", h.size, h.seed, (h.exhaustive) ? "  exhaustive" : "");
+
+  while(fread(&r, sizeof(r), 1, f) == 1)
+    {
+      if ((unsigned) r.type >= AD_TRACE_NB_EVENTS)
+	{
+	  fprintf(stderr, "bad event type %d\n", r.type);
+	  return 1;
+	}
+
+      if (csv)
+	printf("%s,%d,%d,%d,%d,%d,%d,%d\n", event_name[r.type], r.iter, r.cost,
+	       r.v[0], r.v[1], r.v[2], r.v[3], r.v[4]);
+      else
+	Display_Text(&r, h.exhaustive);
+    }
+
+  fclose(f);
+  return 0;
+}
+
+
+
+
+/*
+ *  DISPLAY_TEXT
+ *
+ *  Displays an event as the (old) text log did.
+ */
+static void
+Display_Text(AdTraceRec *r, int exhaustive)
+{
+  switch(r->type)
+    {
+    case AD_TRACE_RESTART:
+      printf("----- restart no: %d ---\n", r->v[0]);
+      break;
+
+    case AD_TRACE_ITER:
+      printf("----- iter no: %d, cost: %d, nb marked: %d ---\n", r->iter, r->cost, r->v[0]);
+      break;
+
+    case AD_TRACE_SWAP:
+      if (!exhaustive)
+	printf("\tswap: %d/%d  nb max/min: %d/%d  new cost: %d\n",
+	       r->v[0], r->v[1], r->v[2], r->v[3], r->v[4]);
+      else
+	printf("\tswap: %d/%d  nb pairs: %d  new cost: %d\n",
+	       r->v[0], r->v[1], r->v[2], r->v[4]);
+      break;
+
+    case AD_TRACE_END_PLATEAU:
+      printf("\tend of plateau, length: %d\n", r->v[0]);
+      break;
+
+    case AD_TRACE_RESET:
+      printf("\t%s - RESET (%d vars)\n",
+	     ((unsigned) r->v[0] <= AD_TRACE_RESET_PLATEAU) ? reset_msg[r->v[0]] : "?", r->v[1]);
+      break;
+
+    case AD_TRACE_MOVE:
+      printf("\tcompound move: %d/%d %d/%d  new cost: %d\n",
+	     r->v[0], r->v[1], r->v[2], r->v[3], r->v[4]);
+      break;
+    }
+}
@@ -0,0 +1,607 @@
+/*
+ *  Adaptive search
+ *
+ *  Copyright (C) 2002-2011 Daniel Diaz, Philippe Codognet and Salvador Abreu
+ *
+ *  adtune.c: offline tuning of the solver parameters by racing
+ *
+ *  Usage: adtune [ OPTION ]... BENCH INSTANCE...
+ *
+ *  Random configurations of the parameters (plus the defaults of the
+ *  bench) are raced (F-race): at each step all the alive configurations
+ *  are run on a new block (an instance and a seed, the same for all
+ *  configurations). After a few blocks, a Friedman test on the ranks is
+ *  done at each step and the configurations significantly worse than the
+ *  best one are eliminated. The runs are done in parallel by launching
+ *  the bench (with --format=csv to get the result of a run).
+ *
+ *  The cost of a run is its CPU time (or PENALTY * cutoff if not solved
+ *  within the cutoff). The winner is written as a profile file which can
+ *  be loaded by any bench with --profile=FILE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include "tools.h"
+
+/*-----------*
+ * Constants *
+ *-----------*/
+
+#define MAX_PARAMS     16
+#define MAX_CONFIGS    1024
+#define PENALTY        10	/* cost of an unsolved run = PENALTY * cutoff (PAR10) */
+
+#define Z_95           1.6449	/* quantile 0.95 of N(0,1) */
+#define Z_975          1.9600	/* quantile 0.975 of N(0,1) */
+
+/*-------*
+ * Types *
+ *-------*/
+
+typedef struct			/* a tuned parameter (a command-line option) */
+{
+  char opt[16];
+  int min, max;
+} Param;
+
+
+typedef struct			/* a configuration */
+{
+  int val[MAX_PARAMS];		/* value of each parameter (-1 = bench default) */
+  int alive;
+  double *cost;			/* [block] cost of the run of each block */
+  double rank_sum;		/* sum of the ranks (alive configs) */
+} Config;
+
+
+typedef struct			/* a running bench */
+{
+  pid_t pid;
+  int fd;			/* read end of the pipe (its stdout) */
+  int config;
+  int block;
+} Job;
+
+/*------------------*
+ * Global variables *
+ *------------------*/
+
+static Param param[MAX_PARAMS] = {	/* the default space */
+  { "-P", 0, 100 },		/* probability to select a local min */
+  { "-f", 0, 10 },		/* freeze loc min */
+  { "-F", 0, 5 },		/* freeze swap */
+  { "-l", 1, 100 },		/* reset limit */
+  { "-p", 1, 50 },		/* reset percent */
+};
+static int nb_param = 5;
+
+static Config config[MAX_CONFIGS];
+static int nb_config = 20;
+
+static int max_block = 50;
+static int first_test = 5;
+static int nb_jobs;
+static int cutoff = 10;
+static int seed = -1;
+static char *out_file = "adtune.prof";
+static char *bench;
+static char **instance;
+static int nb_instance;
+static int *block_seed;
+
+static Job *job;
+
+/*------------*
+ * Prototypes *
+ *------------*/
+
+static void Parse_Cmd_Line(int argc, char *argv[]);
+
+static void Read_Space(char *file_name);
+
+static void Run_Block(int block);
+
+static int Race_Test(int nb_block);
+
+static void Write_Profile(int best, int nb_block);
+
+static void Display_Config(FILE *out, int c);
+
+
+
+
+/*
+ *  MAIN
+ *
+ */
+int
+main(int argc, char *argv[])
+{
+  int b, c, k, best, nb_alive;
+
+  nb_jobs = sysconf(_SC_NPROCESSORS_ONLN);
+  Parse_Cmd_Line(argc, argv);
+
+  if (seed < 0)
+    seed = Randomize();
+  else
+    Randomize_Seed(seed);
+
+  block_seed = malloc(max_block * sizeof(int));
+  job = malloc(nb_jobs * sizeof(Job));
+  if (block_seed == NULL || job == NULL)
+    {
+      fprintf(stderr, "%s:%d malloc failed\n", __FILE__, __LINE__);
+      exit(1);
+    }
+
+  for(b = 0; b < max_block; b++)
+    block_seed[b] = Random(0x7FFFFFFF);
+
+  for(c = 0; c < nb_config; c++) /* config 0 = the defaults of the bench */
+    {
+      for(k = 0; k < nb_param; k++)
+	config[c].val[k] = (c == 0) ? -1 : Random_Interval(param[k].min, param[k].max);
+      config[c].alive = 1;
+      config[c].cost = malloc(max_block * sizeof(double));
+      if (config[c].cost == NULL)
+	{
+	  fprintf(stderr, "%s:%d malloc failed\n", __FILE__, __LINE__);
+	  exit(1);
+	}
+    }
+
+  printf("racing %d configurations of %s on %d instance(s), seed: %d, cutoff: %d secs, %d jobs\n",
+	 nb_config, bench, nb_instance, seed, cutoff, nb_jobs);
+
+  nb_alive = nb_config;
+  for(b = 0; b < max_block && nb_alive > 1; b++)
+    {
+      Run_Block(b);
+
+      if (b + 1 >= first_test)
+	nb_alive = Race_Test(b + 1);
+
+      printf("block %3d: instance %s seed %10d - %d configurations alive\n",
+	     b + 1, instance[b % nb_instance], block_seed[b], nb_alive);
+    }
+
+  Race_Test(b);			/* final ranking */
+
+  best = -1;
+  for(c = 0; c < nb_config; c++)
+    if (config[c].alive && (best < 0 || config[c].rank_sum < config[best].rank_sum))
+      best = c;
+
+  printf("\nbest configuration (mean rank: %.2f over %d blocks): ", config[best].rank_sum / b, b);
+  Display_Config(stdout, best);
+  printf("\n");
+
+  Write_Profile(best, b);
+
+  return 0;
+}
+
+
+
+
+/*
+ *  RUN_BLOCK
+ *
+ *  Runs all alive configurations on a block (nb_jobs at a time).
+ */
+static void
+Run_Block(int block)
+{
+  int c = 0, k, j, nb_run = 0, status;
+  char opt_val[MAX_PARAMS][16], seed_str[16], buff[4096];
+  char *args[2 * MAX_PARAMS + 8];
+  int fd[2], n, len;
+  pid_t pid;
+
+  sprintf(seed_str, "%d", block_seed[block]);
+
+  for(;;)
+    {
+      while(nb_run < nb_jobs && c < nb_config) /* launch */
+	{
+	  if (!config[c].alive)
+	    {
+	      c++;
+	      continue;
+	    }
+
+	  n = 0;
+	  args[n++] = bench;
+	  args[n++] = "--format=csv";
+	  args[n++] = "-s";
+	  args[n++] = seed_str;
+	  for(k = 0; k < nb_param; k++)
+	    if (config[c].val[k] >= 0)
+	      {
+		sprintf(opt_val[k], "%d", config[c].val[k]);
+		args[n++] = param[k].opt;
+		args[n++] = opt_val[k];
+	      }
+	  args[n++] = instance[block % nb_instance];
+	  args[n] = NULL;
+
+	  if (pipe(fd) != 0 || (pid = fork()) < 0)
+	    {
+	      perror("fork");
+	      exit(1);
+	    }
+
+	  if (pid == 0)		/* the bench */
+	    {
+	      struct rlimit rl;
+
+	      rl.rlim_cur = cutoff;
+	      rl.rlim_max = cutoff + 1;
+	      setrlimit(RLIMIT_CPU, &rl); /* SIGXCPU at the cutoff */
+
+	      close(fd[0]);
+	      dup2(fd[1], 1);
+	      if (freopen("/dev/null", "w", stderr) == NULL)
+		{}
+	      execvp(bench, args);
+	      _exit(127);
+	    }
+
+	  close(fd[1]);
+	  job[nb_run].pid = pid;
+	  job[nb_run].fd = fd[0];
+	  job[nb_run].config = c;
+	  job[nb_run].block = block;
+	  nb_run++;
+	  c++;
+	}
+
+      if (nb_run == 0)
+	break;
+
+      pid = wait(&status);	/* some job terminated */
+      for(j = 0; j < nb_run && job[j].pid != pid; j++)
+	;
+      if (j == nb_run)
+	continue;
+
+      len = 0;			/* a record is small: it is in the pipe */
+      while(len < (int) sizeof(buff) - 1 && (n = read(job[j].fd, buff + len, sizeof(buff) - 1 - len)) > 0)
+	len += n;
+      buff[len] = '\0';
+      close(job[j].fd);
+
+      {				/* find solved and cpu_ns in the CSV (header + record) */
+	char *rec = strchr(buff, '\n');
+	int col = 0, col_solved = -1, col_cpu = -1;
+	int solved = 0;
+	double cpu = 0;
+	char *p, *q;
+
+	if (WIFEXITED(status) && WEXITSTATUS(status) == 127)
+	  {
+	    fprintf(stderr, "cannot execute %s\n", bench);
+	    exit(1);
+	  }
+
+	if (rec)
+	  {
+	    *rec++ = '\0';
+	    for(p = strtok(buff, ","); p; p = strtok(NULL, ","), col++)
+	      if (strcmp(p, "solved") == 0)
+		col_solved = col;
+	      else if (strcmp(p, "cpu_ns") == 0)
+		col_cpu = col;
+
+	    for(col = 0, p = rec; p && col <= col_cpu; col++, p = q)
+	      {
+		if ((q = strchr(p, ',')) != NULL)
+		  *q++ = '\0';
+		if (col == col_solved)
+		  solved = atoi(p);
+		if (col == col_cpu)
+		  cpu = atof(p) / 1e9;
+	      }
+	  }
+
+	config[job[j].config].cost[job[j].block] = (solved && cpu <= cutoff) ? cpu : PENALTY * cutoff;
+      }
+
+      job[j] = job[--nb_run];
+    }
+}
+
+
+
+
+/*
+ *  RACE_TEST
+ *
+ *  Ranks the alive configurations on each of the nb_block first blocks
+ *  and computes their rank sums. If the Friedman test rejects the
+ *  hypothesis that all configurations are equivalent, the ones which
+ *  are significantly worse than the best one are eliminated (Conover
+ *  post-hoc test, as in F-race). Returns the nb of alive configurations.
+ */
+static int
+Race_Test(int nb_block)
+{
+  int alive[MAX_CONFIGS];
+  int k = 0, b, i, j, c, best;
+  double rank, a = 0, t, df, chi2, crit, d;
+
+  for(c = 0; c < nb_config; c++)
+    if (config[c].alive)
+      {
+	alive[k++] = c;
+	config[c].rank_sum = 0;
+      }
+
+  if (k <= 1)
+    return k;
+
+  for(b = 0; b < nb_block; b++)
+    for(i = 0; i < k; i++)	/* rank = 1 + nb smaller + (nb equal - 1) / 2 */
+      {
+	double x = config[alive[i]].cost[b];
+
+	rank = 1;
+	for(j = 0; j < k; j++)
+	  if (j != i)
+	    {
+	      if (config[alive[j]].cost[b] < x)
+		rank += 1;
+	      else if (config[alive[j]].cost[b] == x)
+		rank += 0.5;
+	    }
+	config[alive[i]].rank_sum += rank;
+	a += rank * rank;
+      }
+
+  if (nb_block < first_test)
+    return k;
+
+  d = nb_block * k * (k + 1) * (k + 1) / 4.0; /* C of Conover */
+  if (a - d <= 0)		/* all equal */
+    return k;
+
+  t = 0;
+  for(i = 0; i < k; i++)
+    t += (config[alive[i]].rank_sum - nb_block * (k + 1) / 2.0) *
+      (config[alive[i]].rank_sum - nb_block * (k + 1) / 2.0);
+  t = (k - 1) * t / (a - d);
+
+  df = k - 1;			/* Wilson-Hilferty approximation of chi2 quantile */
+  chi2 = df * pow(1 - 2 / (9 * df) + Z_95 * sqrt(2 / (9 * df)), 3);
+  if (t <= chi2)
+    return k;
+
+  best = alive[0];
+  for(i = 1; i < k; i++)
+    if (config[alive[i]].rank_sum < config[best].rank_sum)
+      best = alive[i];
+
+  crit = 1 - t / (nb_block * (k - 1));
+  crit = Z_975 * sqrt(2 * nb_block * ((crit > 0) ? crit : 0) * (a - d) /
+		      ((nb_block - 1) * (k - 1)));
+
+  for(i = 0; i < k; i++)
+    if (config[alive[i]].rank_sum - config[best].rank_sum > crit)
+      config[alive[i]].alive = 0;
+
+  for(c = k = 0; c < nb_config; c++)
+    k += config[c].alive;
+
+  return k;
+}
+
+
+
+
+/*
+ *  DISPLAY_CONFIG
+ *
+ */
+static void
+Display_Config(FILE *out, int c)
+{
+  int k, n = 0;
+
+  for(k = 0; k < nb_param; k++)
+    if (config[c].val[k] >= 0)
+      fprintf(out, "%s%s %d", (n++) ? " " : "", param[k].opt, config[c].val[k]);
+
+  if (n == 0)
+    fprintf(out, "# (the defaults of the bench)");
+}
+
+
+
+
+/*
+ *  WRITE_PROFILE
+ *
+ */
+static void
+Write_Profile(int best, int nb_block)
+{
+  FILE *out;
+  double sum = 0;
+  int b, i;
+
+  if ((out = fopen(out_file, "wt")) == NULL)
+    {
+      perror(out_file);
+      exit(1);
+    }
+
+  for(b = 0; b < nb_block; b++)
+    sum += config[best].cost[b];
+
+  fprintf(out, "# profile written by adtune for %s on:", bench);
+  for(i = 0; i < nb_instance; i++)
+    fprintf(out, " %s", instance[i]);
+  fprintf(out, "\n# %d blocks, mean cost: %g secs (unsolved = %d x %d secs)\n",
+	  nb_block, sum / nb_block, PENALTY, cutoff);
+  fprintf(out, "# use: %s --profile=%s ...\n", bench, out_file);
+  Display_Config(out, best);
+  fprintf(out, "\n");
+
+  fclose(out);
+
+  printf("profile written in %s\n", out_file);
+}
+
+
+
+
+/*
+ *  READ_SPACE
+ *
+ *  Reads the parameter space: one line per parameter: OPTION MIN MAX
+ */
+static void
+Read_Space(char *file_name)
+{
+  FILE *f;
+  char buff[256];
+
+  if ((f = fopen(file_name, "rt")) == NULL)
+    {
+      perror(file_name);
+      exit(1);
+    }
+
+  nb_param = 0;
+  while(fgets(buff, sizeof(buff), f))
+    {
+      if (*buff == '#' || strspn(buff, " \t\r\n") == strlen(buff))
+	continue;
+
+      if (nb_param >= MAX_PARAMS ||
+	  sscanf(buff, "%15s %d %d", param[nb_param].opt, &param[nb_param].min, &param[nb_param].max) != 3 ||
+	  param[nb_param].min < 0 || param[nb_param].min > param[nb_param].max)
+	{
+	  fprintf(stderr, "%s: bad line: %s", file_name, buff);
+	  exit(1);
+	}
+      nb_param++;
+    }
+
+  fclose(f);
+}
+
+
+
+
+#define L(msg) fprintf(stderr, msg "\n")
+
+
+/*
+ *  PARSE_CMD_LINE
+ *
+ */
+static void
+Parse_Cmd_Line(int argc, char *argv[])
+{
+  int i;
+
+  for(i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+      if (argv[i][1] != 'h' && i + 1 >= argc)
+	{
+	  fprintf(stderr, "argument expected after %s\n", argv[i]);
+	  exit(1);
+	}
+
+      switch(argv[i][1])
+	{
+	case 'n':
+	  nb_config = atoi(argv[++i]);
+	  if (nb_config < 2 || nb_config > MAX_CONFIGS)
+	    {
+	      fprintf(stderr, "the nb of configurations must be in 2..%d\n", MAX_CONFIGS);
+	      exit(1);
+	    }
+	  continue;
+
+	case 'b':
+	  max_block = atoi(argv[++i]);
+	  continue;
+
+	case 'm':
+	  first_test = atoi(argv[++i]);
+	  if (first_test < 2)
+	    first_test = 2;
+	  continue;
+
+	case 'j':
+	  nb_jobs = atoi(argv[++i]);
+	  continue;
+
+	case 't':
+	  cutoff = atoi(argv[++i]);
+	  continue;
+
+	case 's':
+	  seed = atoi(argv[++i]);
+	  continue;
+
+	case 'x':
+	  Read_Space(argv[++i]);
+	  continue;
+
+	case 'o':
+	  out_file = argv[++i];
+	  continue;
+
+	case 'h':
+	  fprintf(stderr, "Usage: %s [ OPTION ]... BENCH INSTANCE...\n", argv[0]);
+	  L("");
+	  L("   -n NB       race NB configurations (the 1st one = the defaults, default 20)");
+	  L("   -b NB       at most NB blocks (instance x seed) (default 50)");
+	  L("   -m NB       first elimination test after NB blocks (default 5)");
+	  L("   -j NB       NB runs in parallel (default nb of cpus)");
+	  L("   -t SECS     cutoff of a run in CPU secs (default 10)");
+	  L("   -s SEED     specify random seed");
+	  L("   -x FILE     parameter space, one line per parameter: OPTION MIN MAX");
+	  L("               (default: -P 0 100, -f 0 10, -F 0 5, -l 1 100, -p 1 50)");
+	  L("   -o FILE     write the profile of the best configuration in FILE (default adtune.prof)");
+	  L("   -h          show this help");
+	  L("");
+	  L("INSTANCE is the parameter of the bench (e.g. a size or a file name).");
+	  exit(0);
+
+	default:
+	  fprintf(stderr, "unrecognized option %s (-h for a help)\n", argv[i]);
+	  exit(1);
+	}
+    }
+
+  if (argc - i < 2)
+    {
+      fprintf(stderr, "Usage: %s [ OPTION ]... BENCH INSTANCE... (-h for a help)\n", argv[0]);
+      exit(1);
+    }
+
+  if (max_block < first_test)
+    max_block = first_test;
+  if (nb_jobs <= 0)
+    nb_jobs = 1;
+  if (cutoff <= 0)
+    cutoff = 1;
+
+  bench = argv[i++];
+  instance = argv + i;
+  nb_instance = argc - i;
+}
@@ -11,6 +11,7 @@
 #include <string.h>
 
 #include "ad_solver.h"
+#include "alldiff-utils.c"
 
 
 #if 0
@@ -37,7 +38,13 @@
 static int size;		/* copy of p_ad->size */
 static int *sol;		/* copy of p_ad->sol */
 
-static int *nb_occ;		/* nb occurrences (to compute total cost) 0 is unused */
+static AllDiff dist_ad;		/* the distances 0..size-1 (0 is unused thus missing) */
+
+#ifndef SLOW
+static int last_missing;	/* greatest missing distance (the cost) */
+#else
+static int sum_missing;		/* sum of the missing distances (the cost) */
+#endif
 
 
 
@@ -49,6 +56,10 @@ static int *nb_occ;		/* nb occurrences (to compute total cost) 0 is unused */
 
 /*
  *  MODELING
+ *
+ *  The distances between consecutive values must be all different: they
+ *  are an AllDiff (see alldiff-utils.c) with its bit-vector of missing
+ *  values. The cost is the greatest missing distance (0 if none).
  */
 
 static int
@@ -70,51 +81,37 @@ Solve(AdData *p_ad)
   sol = p_ad->sol;
   size = p_ad->size;
 
-  if (nb_occ == NULL)
-    {
-      nb_occ = (int *) malloc(size * sizeof(int));
-
-      if (nb_occ == NULL)
-	{
-	  printf("%s:%d malloc failed\n", __FILE__, __LINE__);
-	  exit(1);
-	}
-    }
+  if (dist_ad.nb_occ == NULL)
+    AllDiff_Init(&dist_ad, size, 0, 1);
 
   Ad_Solve(p_ad);
 }
 
 
 /*
- *  COST
+ *  MISSING_COST
  *
- *  Computes a cost associated to the array of occurrences.
+ *  Returns the cost associated to the missing distances: the greatest
+ *  one (found in the bit-vector of dist_ad).
  */
 
 static int
-Cost(int nb_occ[])
-
+Missing_Cost(void)
 {
 #ifndef SLOW
 
-  int i = size;
-
-  nb_occ[0] = 0;                /* 0 is unused, use it as a sentinel */
-
-  while(nb_occ[--i])
-    ;
-
-  return i;
+  return last_missing = AllDiff_Last_Missing(&dist_ad);
 
 #else  // less efficient (use it with -p 5 -f 4 -l 2 -P 80)
 
-  int r = 0, i;
+  int i;
 
+  sum_missing = 0;
   for(i = 1; i < size; i++)
-    if (nb_occ[i] == 0)
-      r += i;
+    if (AllDiff_Nb_Occ(&dist_ad, i) == 0)
+      sum_missing += i;
 
-  return r;
+  return sum_missing;
 
 #endif
 }
@@ -122,6 +119,35 @@ Cost(int nb_occ[])
 
 
 
+/*
+ *  INC_OCC / DEC_OCC / REPLACE_OCC
+ *
+ *  Inc_Occ and Dec_Occ update the nb of occurrences of a distance d
+ *  (d == 0 means no distance) but not the bit-vector of missing values:
+ *  they are used by Cost_If_Swap which restores the counters. In SLOW
+ *  mode they also maintain the sum of missing distances in r.
+ *  Replace_Occ (Executed_Swap) replaces an occurrence of old by new.
+ */
+
+#define Nb_Occ(d)      AllDiff_Nb_Occ(&dist_ad, d)
+
+#ifndef SLOW
+
+#define Inc_Occ(d, r)  Nb_Occ(d)++
+#define Dec_Occ(d, r)  Nb_Occ(d)--
+
+#define Replace_Occ(old, new)  AllDiff_Replace(&dist_ad, old, new)
+
+#else
+
+#define Inc_Occ(d, r)  do { if (Nb_Occ(d)++ == 0) r -= (d); } while(0)
+#define Dec_Occ(d, r)  do { if (--Nb_Occ(d) == 0) r += (d); } while(0)
+
+#define Replace_Occ(old, new)  do { Dec_Occ(old, sum_missing); Inc_Occ(new, sum_missing); } while(0)
+
+#endif
+
+
 
 /*
  *  COST_OF_SOLUTION
@@ -136,17 +162,19 @@ Cost_Of_Solution(int should_be_recorded)
 {
   int i;
 
-  memset(nb_occ, 0, size * sizeof(int));
-  
+  AllDiff_Clear(&dist_ad);
+
   for(i = 0; i < size - 1; i++)
-    nb_occ[abs(sol[i] - sol[i + 1])]++;
+    AllDiff_Add(&dist_ad, abs(sol[i] - sol[i + 1]));
+
+  i = Missing_Cost();
 
 #ifdef NO_TRIVIAL
   if (should_be_recorded && Is_Trivial_Solution(sol, size))
     return size;
 #endif
 
-  return Cost(nb_occ);
+  return i;
 }
 
 
@@ -185,10 +213,14 @@ Cost_If_Swap(int current_cost, int i1, int i2)
   s1 = sol[i1];
   s2 = sol[i2];
 
+#ifdef SLOW
+  int r = sum_missing;
+#endif
+
   if (i1 > 0)
     {
-      rem1 = abs(sol[i1 - 1] - s1); nb_occ[rem1]--; 
-      add1 = abs(sol[i1 - 1] - s2); nb_occ[add1]++; 
+      rem1 = abs(sol[i1 - 1] - s1); Dec_Occ(rem1, r); 
+      add1 = abs(sol[i1 - 1] - s2); Inc_Occ(add1, r); 
     }
   else
     rem1 = add1 = 0;
@@ -196,29 +228,51 @@ Cost_If_Swap(int current_cost, int i1, int i2)
 
   if (i1 < i2 - 1)		/* i1 and i2 are not consecutive */
     {
-      rem2 = abs(s1 - sol[i1 + 1]); nb_occ[rem2]--; 
-      add2 = abs(s2 - sol[i1 + 1]); nb_occ[add2]++; 
+      rem2 = abs(s1 - sol[i1 + 1]); Dec_Occ(rem2, r); 
+      add2 = abs(s2 - sol[i1 + 1]); Inc_Occ(add2, r); 
 
-      rem3 = abs(sol[i2 - 1] - s2); nb_occ[rem3]--; 
-      add3 = abs(sol[i2 - 1] - s1); nb_occ[add3]++; 
+      rem3 = abs(sol[i2 - 1] - s2); Dec_Occ(rem3, r); 
+      add3 = abs(sol[i2 - 1] - s1); Inc_Occ(add3, r); 
     }
   else
     rem2 = add2 = rem3 = add3 = 0;
 
   if (i2 < size - 1)
     {
-      rem4 = abs(s2 - sol[i2 + 1]); nb_occ[rem4]--;
-      add4 = abs(s1 - sol[i2 + 1]); nb_occ[add4]++;
+      rem4 = abs(s2 - sol[i2 + 1]); Dec_Occ(rem4, r);
+      add4 = abs(s1 - sol[i2 + 1]); Inc_Occ(add4, r);
     }
   else
     rem4 = add4 = 0;
 
-  int r = Cost(nb_occ);
+#ifndef SLOW
+  /* the greatest missing distance is either a removed distance which is
+   * no longer present or the greatest missing one (the bit-vector is the
+   * one before the swap) not filled
+   */
+  int r = 0, d;
+
+  if (Nb_Occ(rem1) == 0 && rem1 > r)
+    r = rem1;
+  if (Nb_Occ(rem2) == 0 && rem2 > r)
+    r = rem2;
+  if (Nb_Occ(rem3) == 0 && rem3 > r)
+    r = rem3;
+  if (Nb_Occ(rem4) == 0 && rem4 > r)
+    r = rem4;
+
+  for(d = last_missing; d > r; d = AllDiff_Prev_Missing(&dist_ad, d))
+    if (Nb_Occ(d) == 0)
+      {
+	r = d;
+	break;
+      }
+#endif
 
   /* undo */
 
-  nb_occ[rem1]++; nb_occ[rem2]++; nb_occ[rem3]++; nb_occ[rem4]++; 
-  nb_occ[add1]--; nb_occ[add2]--; nb_occ[add3]--; nb_occ[add4]--;
+  Nb_Occ(rem1)++; Nb_Occ(rem2)++; Nb_Occ(rem3)++; Nb_Occ(rem4)++;
+  Nb_Occ(add1)--; Nb_Occ(add2)--; Nb_Occ(add3)--; Nb_Occ(add4)--;
 
   return r;
 }
@@ -254,25 +308,33 @@ Executed_Swap(int i1, int i2)
 
   if (i1 > 0)
     {
-      rem1 = abs(sol[i1 - 1] - s1); nb_occ[rem1]--; 
-      add1 = abs(sol[i1 - 1] - s2); nb_occ[add1]++; 
+      rem1 = abs(sol[i1 - 1] - s1);
+      add1 = abs(sol[i1 - 1] - s2);
+      Replace_Occ(rem1, add1);
     }
 
 
   if (i1 < i2 - 1)              /* i1 and i2 are not consecutive */
     {
-      rem2 = abs(s1 - sol[i1 + 1]); nb_occ[rem2]--; 
-      add2 = abs(s2 - sol[i1 + 1]); nb_occ[add2]++; 
+      rem2 = abs(s1 - sol[i1 + 1]);
+      add2 = abs(s2 - sol[i1 + 1]);
+      Replace_Occ(rem2, add2);
 
-      rem3 = abs(sol[i2 - 1] - s2); nb_occ[rem3]--; 
-      add3 = abs(sol[i2 - 1] - s1); nb_occ[add3]++; 
+      rem3 = abs(sol[i2 - 1] - s2);
+      add3 = abs(sol[i2 - 1] - s1);
+      Replace_Occ(rem3, add3);
     }
 
   if (i2 < size - 1)
     {
-      rem4 = abs(s2 - sol[i2 + 1]); nb_occ[rem4]--;
-      add4 = abs(s1 - sol[i2 + 1]); nb_occ[add4]++;
+      rem4 = abs(s2 - sol[i2 + 1]);
+      add4 = abs(s1 - sol[i2 + 1]);
+      Replace_Occ(rem4, add4);
     }
+
+#ifndef SLOW
+  Missing_Cost();
+#endif
 }
 
 
@@ -385,25 +447,18 @@ Check_Solution(AdData *p_ad)
     }
 
 
-  if (nb_occ == NULL)
-    {
-      nb_occ = (int *) malloc(p_ad->size * sizeof(int));
-      if (nb_occ == NULL)
-	{
-	  printf("%s:%d malloc failed\n", __FILE__, __LINE__);
-	  exit(1);
-	}
-    }
+  if (dist_ad.nb_occ == NULL)
+    AllDiff_Init(&dist_ad, p_ad->size, 0, 1);
 
-  memset(nb_occ, 0, p_ad->size * sizeof(int));
+  AllDiff_Clear(&dist_ad);
 
   for(i = 0; i < p_ad->size - 1; i++)
-    nb_occ[abs(p_ad->sol[i] - p_ad->sol[i + 1])]++;
+    AllDiff_Add(&dist_ad, abs(p_ad->sol[i] - p_ad->sol[i + 1]));
 
   for(i = 1; i < p_ad->size; i++)
-    if (nb_occ[i] > 1)
+    if (AllDiff_Nb_Occ(&dist_ad, i) > 1)
       {
-	printf("ERROR distance %d appears %d times\n", i, nb_occ[i]);
+	printf("ERROR distance %d appears %d times\n", i, AllDiff_Nb_Occ(&dist_ad, i));
 	r = 0;
       }
 
@@ -0,0 +1,270 @@
+#ifndef _ALLDIFF_UTILS
+#define _ALLDIFF_UTILS
+
+/*
+ *  Adaptive search
+ *
+ *  Copyright (C) 2002-2011 Daniel Diaz, Philippe Codognet and Salvador Abreu
+ *
+ *  alldiff-utils.c: incremental all-different constraint
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/*
+ *  An AllDiff records the multiset of values of a group of variables
+ *  (a row, a column, a set of distances...). Values are in
+ *  base..base+nb_val-1. A problem uses as many instances as it has
+ *  all-different constraints and tells each of them which values
+ *  enter and leave it.
+ *
+ *  The cost of an instance is the number of repeated values:
+ *  nb_dup = Sum max(0, nb_occ[v] - 1)
+ *  (i.e. the nb of variables to change to satisfy the constraint).
+ *
+ *  Replacing one occurrence of a value by another one changes this cost
+ *  by -1, 0 or +1 and is evaluated in O(1). A swap of 2 variables of
+ *  different groups is 2 replacements (one per group), a swap inside a
+ *  group does not change its cost.
+ *
+ *  The functions are static: a problem includes this file (several
+ *  problems can then be linked together, see adsolve).
+ *
+ *  Optionally (with_missing) a bit-vector of the missing values
+ *  (nb_occ[v] == 0) is maintained: the smallest/greatest missing value
+ *  is then found a word (64 values) at a time.
+ *
+ *  Users: quasigroup.c (rows and columns) and all-interval.c (the
+ *  distances, with the missing values). qwh.c (not built) is not ported:
+ *  its column counters start from the fixed values of the column and
+ *  are rebuilt by a full scan which also records the first hole of each
+ *  value and the holes out of their domain (a one-word BitVec since the
+ *  order is <= 50), it has no incremental cost.
+ */
+
+typedef unsigned short ADOcc;	/* a group has at most 65535 variables */
+typedef unsigned long long ADBits;
+
+#define AD_BITS_PER_WORD  (8 * (int) sizeof(ADBits))
+
+typedef struct {
+  int nb_val;			/* nb of possible values */
+  int base;			/* smallest value */
+  int nb_dup;			/* cost: nb of repeated values */
+  ADOcc *nb_occ;		/* [0..nb_val-1]: nb of occurrences of base+i */
+  ADBits *missing;		/* bit i set iff base+i is missing (or NULL) */
+} AllDiff;
+
+
+
+
+/*
+ *  ALLDIFF_INIT
+ *
+ *  Allocates an instance for the values base..base+nb_val-1 (with the
+ *  bit-vector of missing values if with_missing).
+ */
+static inline void
+AllDiff_Init(AllDiff *a, int nb_val, int base, int with_missing)
+{
+  a->nb_val = nb_val;
+  a->base = base;
+  a->nb_occ = (ADOcc *) malloc(nb_val * sizeof(ADOcc));
+  a->missing = NULL;
+  if (with_missing)
+    a->missing = (ADBits *) malloc((nb_val / AD_BITS_PER_WORD + 1) * sizeof(ADBits));
+
+  if (a->nb_occ == NULL || (with_missing && a->missing == NULL))
+    {
+      fprintf(stderr, "%s:%d malloc failed\n", __FILE__, __LINE__);
+      exit(1);
+    }
+}
+
+
+
+
+/*
+ *  ALLDIFF_FREE
+ *
+ *  Frees the arrays of an instance (e.g. in Free_Problem).
+ */
+static inline void
+AllDiff_Free(AllDiff *a)
+{
+  free(a->nb_occ);
+  free(a->missing);
+}
+
+
+
+
+/*
+ *  ALLDIFF_CLEAR
+ *
+ *  Empties the group (all values are missing).
+ */
+static inline void
+AllDiff_Clear(AllDiff *a)
+{
+  int i, nb_word;
+
+  a->nb_dup = 0;
+  memset(a->nb_occ, 0, a->nb_val * sizeof(ADOcc));
+
+  if (a->missing)
+    {
+      nb_word = a->nb_val / AD_BITS_PER_WORD + 1;
+      for(i = 0; i < nb_word; i++)
+	a->missing[i] = (ADBits) -1;
+      a->missing[nb_word - 1] = ((ADBits) 1 << (a->nb_val % AD_BITS_PER_WORD)) - 1;
+    }
+}
+
+
+
+
+#define AllDiff_Cost(a)          ((a)->nb_dup)
+#define AllDiff_Nb_Occ(a, v)     ((a)->nb_occ[(v) - (a)->base])
+
+#define AllDiff_Bit_Set(a, i)    ((a)->missing[(i) / AD_BITS_PER_WORD] |= (ADBits) 1 << ((i) % AD_BITS_PER_WORD))
+#define AllDiff_Bit_Reset(a, i)  ((a)->missing[(i) / AD_BITS_PER_WORD] &= ~((ADBits) 1 << ((i) % AD_BITS_PER_WORD)))
+
+
+
+/*
+ *  ALLDIFF_ADD / ALLDIFF_REMOVE
+ *
+ *  A value enters / leaves the group.
+ */
+static inline void
+AllDiff_Add(AllDiff *a, int v)
+{
+  int i = v - a->base;
+
+  if (a->nb_occ[i]++ > 0)
+    a->nb_dup++;
+  else if (a->missing)
+    AllDiff_Bit_Reset(a, i);
+}
+
+
+static inline void
+AllDiff_Remove(AllDiff *a, int v)
+{
+  int i = v - a->base;
+
+  if (--a->nb_occ[i] > 0)
+    a->nb_dup--;
+  else if (a->missing)
+    AllDiff_Bit_Set(a, i);
+}
+
+
+
+
+/*
+ *  ALLDIFF_DELTA_REPLACE
+ *
+ *  Cost change if one occurrence of old is replaced by new (nothing is
+ *  modified).
+ */
+static inline int
+AllDiff_Delta_Replace(AllDiff *a, int old, int new)
+{
+  if (old == new)
+    return 0;
+
+  return (AllDiff_Nb_Occ(a, new) > 0) - (AllDiff_Nb_Occ(a, old) > 1);
+}
+
+
+static inline void
+AllDiff_Replace(AllDiff *a, int old, int new)
+{
+  if (old == new)
+    return;
+
+  AllDiff_Remove(a, old);
+  AllDiff_Add(a, new);
+}
+
+
+
+
+/*
+ *  ALLDIFF_LAST_MISSING
+ *
+ *  Returns the greatest missing value (base - 1 if none).
+ *  Needs the bit-vector of missing values.
+ */
+static inline int
+AllDiff_Last_Missing(AllDiff *a)
+{
+  int w = a->nb_val / AD_BITS_PER_WORD;
+
+  for(; w >= 0; w--)
+    if (a->missing[w])
+      return a->base + w * AD_BITS_PER_WORD + AD_BITS_PER_WORD - 1 - __builtin_clzll(a->missing[w]);
+
+  return a->base - 1;
+}
+
+
+/*
+ *  ALLDIFF_PREV_MISSING
+ *
+ *  Returns the greatest missing value < v (base - 1 if none), e.g. to
+ *  enumerate the missing values from AllDiff_Last_Missing downward.
+ *  Needs the bit-vector of missing values.
+ */
+static inline int
+AllDiff_Prev_Missing(AllDiff *a, int v)
+{
+  int i = v - a->base - 1;	/* greatest index to consider */
+  int w;
+  ADBits bits;
+
+  if (i < 0)
+    return a->base - 1;
+
+  w = i / AD_BITS_PER_WORD;
+  bits = a->missing[w] & ((ADBits) -1 >> (AD_BITS_PER_WORD - 1 - i % AD_BITS_PER_WORD));
+
+  for(;;)
+    {
+      if (bits)
+	return a->base + w * AD_BITS_PER_WORD + AD_BITS_PER_WORD - 1 - __builtin_clzll(bits);
+
+      if (--w < 0)
+	return a->base - 1;
+
+      bits = a->missing[w];
+    }
+}
+
+
+/*
+ *  ALLDIFF_FIRST_MISSING
+ *
+ *  Returns the smallest missing value (base - 1 if none).
+ *  Needs the bit-vector of missing values.
+ */
+static inline int
+AllDiff_First_Missing(AllDiff *a)
+{
+  int nb_word = a->nb_val / AD_BITS_PER_WORD + 1;
+  int w;
+
+  for(w = 0; w < nb_word; w++)
+    if (a->missing[w])
+      return a->base + w * AD_BITS_PER_WORD + __builtin_ctzll(a->missing[w]);
+
+  return a->base - 1;
+}
+
+
+#endif /* !_ALLDIFF_UTILS */
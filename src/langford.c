@@ -48,6 +48,9 @@ static int order;		/* size / K */
 
 static int *err;                /* errors on each value (0..order-1) */
 
+static int *occ_pos;		/* sorted positions of the K occurrences of each value (K per value) */
+static int *occ_rank;		/* rank of each variable in occ_pos[] of its value (0..K-1) */
+
 
 #ifdef LANGFORD
 #define DIST_OK(x)  ((x) + 2)
@@ -169,6 +172,11 @@ static int *err;                /* errors on each value (0..order-1) */
  *  err[x] = 1 iff the distance between both occurrences of x is invalid
  *  (i.e. the distance between indices are != x + 2 for Langford and x + 1 for Skolem)
  *
+ *  To evaluate a swap without sorting the occurrences, the positions of the K
+ *  occurrences of x are kept sorted in occ_pos[x * K .. x * K + K - 1] and 
+ *  occ_rank[i] gives the rank of variable i among the occurrences of its value.
+ *  Only the entries of the 2 values involved in a swap are updated.
+ *
  *  Remark: (Langford) the value v = order has intial an domain which is restricted.
  *          The postition of the first occurence cannot appear [order-2 .. order]
  *          For instance for n = 9, the first position of 9 cannot be 7,8,9
@@ -194,7 +202,9 @@ Solve(AdData *p_ad)
   if (err == NULL)
     {
       err = (int *) malloc(order * sizeof(int));
-      if (err == NULL)
+      occ_pos = (int *) malloc(size * sizeof(int));
+      occ_rank = (int *) malloc(size * sizeof(int));
+      if (err == NULL || occ_pos == NULL || occ_rank == NULL)
         {
           fprintf(stderr, "%s:%d malloc failed\n", __FILE__, __LINE__);
           exit(1);
@@ -268,6 +278,80 @@ Compute_Error(int x)		/* here x < order */
 
 
 
+/*
+ *  RECORD_VALUE
+ *
+ *  Sorts the positions of the occurrences of the value x (x in 0..order-1),
+ *  records them in occ_pos[] / occ_rank[] and records its error in err[x].
+ */
+
+static int
+Record_Value(int x)
+{
+  int *pos = occ_pos + x * K;
+  int ind[K];
+  int i, k, r;
+  int e = 0;
+
+  for(k = 0, i = x; k < K; k++, i += order) /* insertion sort of the K variables of x */
+    {
+      for(r = k; r > 0 && sol[ind[r - 1]] > sol[i]; r--)
+	ind[r] = ind[r - 1];
+      ind[r] = i;
+    }
+
+  for(r = 0; r < K; r++)
+    {
+      i = ind[r];
+      occ_rank[i] = r;
+      pos[r] = sol[i];
+      if (r > 0 && pos[r] - pos[r - 1] != DIST_OK(x))
+	e++;
+    }
+
+  return err[x] = e;
+}
+
+
+
+
+/*
+ *  ERROR_IF_MOVED
+ *
+ *  Returns the error of the value x if its occurrence of rank r is moved to 
+ *  position p (the other occurrences are unchanged).
+ */
+
+static __inline__ int
+Error_If_Moved(int x, int r, int p)
+{
+  int *pos = occ_pos + x * K;
+
+#if K == 2
+
+  return (abs(p - pos[1 - r]) != DIST_OK(x));
+
+#else
+
+  int a, b;			/* the 2 other occurrences (a < b) */
+
+  a = pos[r == 0];
+  b = pos[2 - (r == 2)];
+
+  if (p < a)
+    return (a - p != DIST_OK(x)) + (b - a != DIST_OK(x));
+
+  if (p > b)
+    return (b - a != DIST_OK(x)) + (p - b != DIST_OK(x));
+
+  return (p - a != DIST_OK(x)) + (b - p != DIST_OK(x));
+
+#endif
+}
+
+
+
+
 /*
  *  COST_OF_SOLUTION
  *
@@ -284,9 +368,7 @@ Cost_Of_Solution(int should_be_recorded)
 
   for(x = 0; x < order; x++)
     {
-      e = Compute_Error(x);
-      if (should_be_recorded)
-	err[x] = e;
+      e = (should_be_recorded) ? Record_Value(x) : Compute_Error(x);
       r += e;
     }
 
@@ -328,7 +410,6 @@ Cost_If_Swap(int current_cost, int i1, int i2)
 {
   int x = i1 % order;		/* value to exchange (in 0..order - 1) */
   int y = i2 % order;
-  int tmp;
 
 //#define CHECK
 
@@ -346,31 +427,26 @@ Cost_If_Swap(int current_cost, int i1, int i2)
     return current_cost + 1;	/* for K == 3 don't return current_cost to avoid "false" plateau */
 #endif
 
-  tmp = sol[i1];
-  sol[i1] = sol[i2];
-  sol[i2] = tmp;
-
-
   current_cost -= err[x];
   current_cost -= err[y];
 
-  current_cost += Compute_Error(x);
-  current_cost += Compute_Error(y);
+  current_cost += Error_If_Moved(x, occ_rank[i1], sol[i2]);
+  current_cost += Error_If_Moved(y, occ_rank[i2], sol[i1]);
 
 #ifdef CHECK
+  int tmp = sol[i1];
+  sol[i1] = sol[i2];
+  sol[i2] = tmp;
+
   c = Cost_Of_Solution(0);
   if (current_cost != c)
     {
       printf("ERROR2 %d <=> %d: %d should be %d\n", i1, i2, current_cost, c);
       current_cost = c;
     }
-#endif
 
   sol[i2] = sol[i1];
   sol[i1] = tmp;
-
-#ifdef CHECK
-  //  Cost_Of_Solution(0);
 #endif
 
   return current_cost;
@@ -394,8 +470,18 @@ Executed_Swap(int i1, int i2)
   int x = i1 % order;
   int y = i2 % order;
 
-  err[x] = Compute_Error(x);
-  err[y] = Compute_Error(y);
+  int k;
+
+  Record_Value(x);
+  Record_Value(y);
+
+  for(k = 0; k < K; k++)	/* the other occurrences of x and y can be in conflict */
+    {
+      if (err[x])
+	Ad_Conflict_Add(x + k * order);
+      if (err[y])
+	Ad_Conflict_Add(y + k * order);
+    }
 #else
   Cost_Of_Solution(1);
 #endif
@@ -420,6 +506,7 @@ Init_Parameters(AdData *p_ad)
   p_ad->size = order * K;
 
   p_ad->first_best = 1;
+  p_ad->conflict_set = 1;
 
 #ifdef LANGFORD
   if ((K == 2 && order % 4 != 0 && order % 4 != 3) ||
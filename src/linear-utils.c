@@ -0,0 +1,366 @@
+#ifndef _LINEAR_UTILS
+#define _LINEAR_UTILS
+
+/*
+ *  Adaptive search
+ *
+ *  Copyright (C) 2002-2011 Daniel Diaz, Philippe Codognet and Salvador Abreu
+ *
+ *  linear-utils.c: sparse linear sum constraints (incremental evaluation)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tools.h"
+
+
+/*
+ *  A problem is a set of linear equations over a permutation sol[]:
+ *
+ *  for each constraint j: Sum coeff * sol[var] = rhs[j]
+ *
+ *  The file is in CSR (compressed sparse row) form:
+ *
+ *    nb_var nb_cstr nb_nz
+ *    row_start[0] ... row_start[nb_cstr]     (row_start[nb_cstr] = nb_nz)
+ *    row_var[0] ... row_var[nb_nz-1]         (var index in 0..nb_var-1)
+ *    row_coeff[0] ... row_coeff[nb_nz-1]
+ *    rhs[0] ... rhs[nb_cstr-1]
+ *
+ *  The terms of constraint j are row_start[j]..row_start[j+1]-1.
+ *  A variable can appear several times in a constraint.
+ *
+ *  The transposed (by variable) form is built at load time: the
+ *  constraints of var i are col_start[i]..col_start[i+1]-1, sorted in
+ *  increasing order, each one only once (coefficients summed).
+ *
+ *  The residual of a constraint is res[j] = -rhs[j] + Sum coeff * sol[var]
+ *  The cost is Sum |res[j]|
+ */
+
+typedef struct {
+  int nb_var;			/* number of variables */
+  int nb_cstr;			/* number of constraints */
+  int nb_nz;			/* number of terms (non zeros) */
+
+  int *row_start;		/* CSR by constraint */
+  int *row_var;
+  int *row_coeff;
+  int *rhs;
+
+  int *col_start;		/* CSR by variable (transposed) */
+  int *col_cstr;
+  int *col_coeff;
+} LINInfo;
+
+
+
+
+static int *
+LIN_Alloc_Vector(int n)
+{
+  int *v = malloc((n + 1) * sizeof(int));
+
+  if (v == NULL)
+    {
+      fprintf(stderr, "%s:%d malloc failed\n", __FILE__, __LINE__);
+      exit(1);
+    }
+  return v;
+}
+
+
+static void
+LIN_Read_Vector(FILE *f, int n, int *v, char *what)
+{
+  int i;
+
+  for(i = 0; i < n; i++)
+    if (fscanf(f, "%d", &v[i]) != 1)
+      {
+	fprintf(stderr, "error while reading %s at [%d]\n", what, i);
+	exit(1);
+      }
+}
+
+
+
+
+/*
+ *  LIN_BUILD_TRANSPOSED
+ *
+ *  Builds the by-variable form (col_*) from the by-constraint form.
+ */
+static void
+LIN_Build_Transposed(LINInfo *li)
+{
+  int n = li->nb_var;
+  int *count = LIN_Alloc_Vector(n);
+  int i, j, k, p;
+
+  li->col_start = LIN_Alloc_Vector(n + 1);
+  li->col_cstr = LIN_Alloc_Vector(li->nb_nz);
+  li->col_coeff = LIN_Alloc_Vector(li->nb_nz);
+
+  memset(count, 0, n * sizeof(int));
+  for(k = 0; k < li->nb_nz; k++)
+    count[li->row_var[k]]++;
+
+  li->col_start[0] = 0;
+  for(i = 0; i < n; i++)
+    li->col_start[i + 1] = li->col_start[i] + count[i];
+
+  memset(count, 0, n * sizeof(int)); /* now used as nb of entries of var i */
+
+  for(j = 0; j < li->nb_cstr; j++) /* rows in order: col_cstr is sorted */
+    for(k = li->row_start[j]; k < li->row_start[j + 1]; k++)
+      {
+	i = li->row_var[k];
+	p = li->col_start[i] + count[i];
+	if (count[i] > 0 && li->col_cstr[p - 1] == j) /* var twice in a cstr */
+	  {
+	    li->col_coeff[p - 1] += li->row_coeff[k];
+	    continue;
+	  }
+	li->col_cstr[p] = j;
+	li->col_coeff[p] = li->row_coeff[k];
+	count[i]++;
+      }
+
+  /* compact (entries merged above leave holes at the end of a var) */
+
+  p = 0;
+  for(i = 0; i < n; i++)
+    {
+      int start = li->col_start[i];
+
+      li->col_start[i] = p;
+      for(k = start; k < start + count[i]; k++, p++)
+	{
+	  li->col_cstr[p] = li->col_cstr[k];
+	  li->col_coeff[p] = li->col_coeff[k];
+	}
+    }
+  li->col_start[n] = p;
+
+  free(count);
+}
+
+
+
+
+/*
+ *  LIN_LOAD_PROBLEM
+ *
+ *  file_name: the file name of the problem (CSR form, see above)
+ *  li: the ptr to the info structure
+ *  header_only: only read nb_var, nb_cstr and nb_nz
+ *
+ *  Returns the number of variables
+ */
+int
+LIN_Load_Problem(char *file_name, LINInfo *li, int header_only)
+{
+  FILE *f;
+  int j;
+
+  if ((f = Open_Instance(file_name)) == NULL)
+    {
+      perror(file_name);
+      exit(1);
+    }
+
+  if (fscanf(f, "%d %d %d", &li->nb_var, &li->nb_cstr, &li->nb_nz) != 3 ||
+      li->nb_var <= 0 || li->nb_cstr <= 0 || li->nb_nz < 0)
+    {
+      fprintf(stderr, "error while reading the header (nb_var nb_cstr nb_nz)\n");
+      exit(1);
+    }
+
+  if (!header_only)
+    {
+      li->row_start = LIN_Alloc_Vector(li->nb_cstr + 1);
+      li->row_var = LIN_Alloc_Vector(li->nb_nz);
+      li->row_coeff = LIN_Alloc_Vector(li->nb_nz);
+      li->rhs = LIN_Alloc_Vector(li->nb_cstr);
+
+      LIN_Read_Vector(f, li->nb_cstr + 1, li->row_start, "row start");
+      LIN_Read_Vector(f, li->nb_nz, li->row_var, "variable index");
+      LIN_Read_Vector(f, li->nb_nz, li->row_coeff, "coefficient");
+      LIN_Read_Vector(f, li->nb_cstr, li->rhs, "right hand side");
+
+      if (li->row_start[0] != 0 || li->row_start[li->nb_cstr] != li->nb_nz)
+	{
+	  fprintf(stderr, "bad row start (must go from 0 to %d)\n", li->nb_nz);
+	  exit(1);
+	}
+
+      for(j = 0; j < li->nb_cstr; j++)
+	if (li->row_start[j] > li->row_start[j + 1])
+	  {
+	    fprintf(stderr, "row start not increasing at [%d]\n", j);
+	    exit(1);
+	  }
+
+      for(j = 0; j < li->nb_nz; j++)
+	if ((unsigned) li->row_var[j] >= (unsigned) li->nb_var)
+	  {
+	    fprintf(stderr, "bad variable index %d at [%d]\n", li->row_var[j], j);
+	    exit(1);
+	  }
+
+      LIN_Build_Transposed(li);
+    }
+
+  fclose(f);
+
+  return li->nb_var;
+}
+
+
+
+
+/*
+ *  LIN_FREE_PROBLEM
+ *
+ *  Frees the arrays allocated by LIN_Load_Problem.
+ */
+void
+LIN_Free_Problem(LINInfo *li)
+{
+  free(li->row_start);
+  free(li->row_var);
+  free(li->row_coeff);
+  free(li->rhs);
+  free(li->col_start);
+  free(li->col_cstr);
+  free(li->col_coeff);
+}
+
+
+
+
+/*
+ *  LIN_COST
+ *
+ *  Returns the cost of sol. If res != NULL records the residuals.
+ */
+int
+LIN_Cost(LINInfo *li, int *sol, int *res)
+{
+  int j, k, x;
+  int r = 0;
+
+  for(j = 0; j < li->nb_cstr; j++)
+    {
+      x = -li->rhs[j];
+      for(k = li->row_start[j]; k < li->row_start[j + 1]; k++)
+	x += li->row_coeff[k] * sol[li->row_var[k]];
+
+      if (res)
+	res[j] = x;
+      r += abs(x);
+    }
+
+  return r;
+}
+
+
+
+
+/*
+ *  LIN_COST_ON_VARIABLE
+ *
+ *  Projection of the residuals on var i: | Sum coeff * res[j] |
+ */
+int
+LIN_Cost_On_Variable(LINInfo *li, int *res, int i)
+{
+  int k;
+  int r = 0;
+
+  for(k = li->col_start[i]; k < li->col_start[i + 1]; k++)
+    r += li->col_coeff[k] * res[li->col_cstr[k]];
+
+  return abs(r);
+}
+
+
+
+
+/*
+ *  LIN_COST_IF_SWAP
+ *
+ *  Evaluates the new cost if sol[i1] and sol[i2] are swapped.
+ *  Only the constraints of i1 and i2 are touched (merge of both
+ *  sorted lists, a constraint of both is adjusted once).
+ */
+
+#define LIN_Adjust(r, diff, x)   r = r - abs(x) + abs((x) + (diff))
+
+int
+LIN_Cost_If_Swap(LINInfo *li, int *res, int *sol, int current_cost, int i1, int i2)
+{
+  int k1 = li->col_start[i1], end1 = li->col_start[i1 + 1];
+  int k2 = li->col_start[i2], end2 = li->col_start[i2 + 1];
+  int diff = sol[i2] - sol[i1];	/* i1 gets +diff, i2 gets -diff */
+  int j1, j2;
+  int r = current_cost;
+
+  while(k1 < end1 && k2 < end2)
+    {
+      j1 = li->col_cstr[k1];
+      j2 = li->col_cstr[k2];
+
+      if (j1 < j2)
+	{
+	  LIN_Adjust(r, li->col_coeff[k1] * diff, res[j1]);
+	  k1++;
+	}
+      else if (j2 < j1)
+	{
+	  LIN_Adjust(r, -li->col_coeff[k2] * diff, res[j2]);
+	  k2++;
+	}
+      else
+	{
+	  LIN_Adjust(r, (li->col_coeff[k1] - li->col_coeff[k2]) * diff, res[j1]);
+	  k1++;
+	  k2++;
+	}
+    }
+
+  for(; k1 < end1; k1++)
+    LIN_Adjust(r, li->col_coeff[k1] * diff, res[li->col_cstr[k1]]);
+
+  for(; k2 < end2; k2++)
+    LIN_Adjust(r, -li->col_coeff[k2] * diff, res[li->col_cstr[k2]]);
+
+  return r;
+}
+
+
+
+
+/*
+ *  LIN_EXECUTED_SWAP
+ *
+ *  Updates the residuals after sol[i1] and sol[i2] have been swapped.
+ */
+void
+LIN_Executed_Swap(LINInfo *li, int *res, int *sol, int i1, int i2)
+{
+  int diff = sol[i1] - sol[i2];	/* swap already executed */
+  int k;
+
+  for(k = li->col_start[i1]; k < li->col_start[i1 + 1]; k++)
+    res[li->col_cstr[k]] += li->col_coeff[k] * diff;
+
+  for(k = li->col_start[i2]; k < li->col_start[i2 + 1]; k++)
+    res[li->col_cstr[k]] -= li->col_coeff[k] * diff;
+}
+
+
+#endif /* !_LINEAR_UTILS */
@@ -0,0 +1,252 @@
+/*
+ *  Adaptive search
+ *
+ *  Copyright (C) 2002-2011 Daniel Diaz, Philippe Codognet and Salvador Abreu
+ *
+ *  linear.c: linear sum equations over a permutation (read from a file)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ad_solver.h"
+
+#include "linear-utils.c"
+
+
+/*-----------*
+ * Constants *
+ *-----------*/
+
+/*-------*
+ * Types *
+ *-------*/
+
+/*------------------*
+ * Global variables *
+ *------------------*/
+
+static int size;		/* copy of p_ad->size */
+static int *sol;		/* copy of p_ad->sol */
+
+static LINInfo lin_info;
+static int *res;		/* residuals (errors) on constraints */
+
+
+/*------------*
+ * Prototypes *
+ *------------*/
+
+
+/*
+ *  MODELING
+ *
+ *  sol[i] = value of the ith variable (i in 0..size-1), value in 1..size
+ *
+ *  The constraints are read from a file (CSR form, see linear-utils.c):
+ *  for each constraint j: Sum coeff * sol[var] = rhs[j]
+ *
+ *  res[j] = -rhs[j] + Sum coeff * sol[var]
+ *
+ *                   nb_cstr-1
+ *  The total cost = Sum | res[j] |
+ *                   j=0
+ *
+ *  The projection on a variable i
+ *
+ *                 nb_cstr-1
+ *  err_var[i] = |  Sum res[j] * coeff(i,j) |
+ *                  j=0
+ *
+ *  alpha.c is the hard-coded version of this model (20 equations over
+ *  26 letters with coefficients = nb of occurrences), alpha.lin is the
+ *  same problem as a file (e.g. linear -c alpha.lin).
+ */
+
+
+/*
+ *  SOLVE
+ *
+ *  Initializations needed for the resolution.
+ */
+
+void
+Solve(AdData *p_ad)
+{
+  sol = p_ad->sol;
+  size = p_ad->size;
+
+  if (res == NULL)		/* problem not yet read */
+    {
+      LIN_Load_Problem(p_ad->param_file, &lin_info, 0);
+      res = LIN_Alloc_Vector(lin_info.nb_cstr);
+    }
+
+  Ad_Solve(p_ad);
+}
+
+
+
+/*
+ *  FREE_PROBLEM
+ *
+ *  Forgets the current instance (the next Solve reads p_ad->param_file).
+ */
+
+void
+Free_Problem(AdData *p_ad)
+{
+  if (res == NULL)
+    return;
+
+  LIN_Free_Problem(&lin_info);
+  free(res);
+  res = NULL;
+}
+
+
+
+/*
+ *  COST_OF_SOLUTION
+ *
+ *  Returns the total cost of the current solution.
+ *  Also computes errors on constraints for subsequent calls to
+ *  Cost_On_Variable, Cost_If_Swap and Executed_Swap.
+ */
+
+int
+Cost_Of_Solution(int should_be_recorded)
+{
+  return LIN_Cost(&lin_info, sol, (should_be_recorded) ? res : NULL);
+}
+
+
+
+/*
+ *  COST_ON_VARIABLE
+ *
+ *  Evaluates the error on a variable.
+ */
+
+int
+Cost_On_Variable(int i)
+{
+  return LIN_Cost_On_Variable(&lin_info, res, i);
+}
+
+
+
+/*
+ *  COST_IF_SWAP
+ *
+ *  Evaluates the new total cost for a swap.
+ */
+
+int
+Cost_If_Swap(int current_cost, int i1, int i2)
+{
+  return LIN_Cost_If_Swap(&lin_info, res, sol, current_cost, i1, i2);
+}
+
+
+
+/*
+ *  EXECUTED_SWAP
+ *
+ *  Records a swap.
+ */
+
+void
+Executed_Swap(int i1, int i2)
+{
+  LIN_Executed_Swap(&lin_info, res, sol, i1, i2);
+}
+
+
+
+
+int param_needed = -1;		/* overwrite var of main.c */
+
+/*
+ *  INIT_PARAMETERS
+ *
+ *  Initialization function.
+ */
+
+void
+Init_Parameters(AdData *p_ad)
+{
+  LINInfo li;
+
+  p_ad->size = LIN_Load_Problem(p_ad->param_file, &li, 1); /* only read the header */
+
+  printf("%d variables, %d constraints, %d terms\n", li.nb_var, li.nb_cstr, li.nb_nz);
+
+  p_ad->base_value = 1;
+				/* defaults (as alpha) */
+  if (p_ad->prob_select_loc_min == -1)
+    p_ad->prob_select_loc_min = 10000; /* not used */
+
+  if (p_ad->freeze_loc_min == -1)
+    p_ad->freeze_loc_min = 2;
+
+  if (p_ad->freeze_swap == -1)
+    p_ad->freeze_swap = 0;
+
+  if (p_ad->reset_limit == -1)
+    p_ad->reset_limit = (p_ad->size / 4) + 1;
+
+  if (p_ad->reset_percent == -1)
+    p_ad->reset_percent = 5;
+
+  if (p_ad->restart_limit == -1)
+    p_ad->restart_limit = 10000000;
+
+  if (p_ad->restart_max == -1)
+    p_ad->restart_max = 0;
+}
+
+
+
+
+/*
+ *  CHECK_SOLUTION
+ *
+ *  Checks if the solution is valid.
+ */
+
+int
+Check_Solution(AdData *p_ad)
+{
+  LINInfo li;
+  int j, k, x;
+  int r = 1;
+
+  int i = Random_Permut_Check(p_ad->sol, p_ad->size, p_ad->actual_value, p_ad->base_value);
+
+  if (i >= 0)
+    {
+      printf("ERROR: not a valid permutation, error at [%d] = %d\n", i, p_ad->sol[i]);
+      return 0;
+    }
+
+  LIN_Load_Problem(p_ad->param_file, &li, 0); /* recheck from the file */
+
+  for(j = 0; j < li.nb_cstr; j++)
+    {
+      x = 0;
+      for(k = li.row_start[j]; k < li.row_start[j + 1]; k++)
+	x += li.row_coeff[k] * p_ad->sol[li.row_var[k]];
+
+      if (x != li.rhs[j])
+	{
+	  printf("ERROR constraint %d, sum: %d should be %d\n", j + 1, x, li.rhs[j]);
+	  r = 0;
+	}
+    }
+
+  LIN_Free_Problem(&li);
+
+  return r;
+}
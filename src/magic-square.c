@@ -17,6 +17,9 @@
  * Constants *
  *-----------*/
 
+#define XREF_MAX_SIDE  0x7fff	/* line and column are stored on 15 bits */
+#define MAX_SIDE       255	/* the largest total cost fits an int (see below) */
+
 /*-------*
  * Types *
  *-------*/
@@ -37,8 +40,8 @@ typedef struct
 
 
 #define XSet(xr, line, col, diag1, diag2)   xr.w1 = (diag1 << 15) | line; xr.w2 = (diag2 << 15) | col
-#define XGetL(xr)     (xr.w1 & 0x7f)
-#define XGetC(xr)     (xr.w2 & 0x7f)
+#define XGetL(xr)     (xr.w1 & 0x7fff)
+#define XGetC(xr)     (xr.w2 & 0x7fff)
 #define XIsOnD1(xr)   (xr.w1 < 0)
 #define XIsOnD2(xr)   (xr.w2 < 0)
 
@@ -47,8 +50,8 @@ typedef struct
 typedef unsigned int XRef;
 
 #define XSet(xr, line, col, diag1, diag2)   xr = (diag1 << 31) | (col << 16) | (diag2 << 15) | line
-#define XGetL(xr)     (xr & 0x7f)
-#define XGetC(xr)     ((xr >> 16) & 0x7f)
+#define XGetL(xr)     (xr & 0x7fff)
+#define XGetC(xr)     ((xr >> 16) & 0x7fff)
 #define XIsOnD1(xr)   ((int) xr < 0)
 #define XIsOnD2(xr)   ((xr & 0x00008000) != 0)
 
@@ -57,8 +60,8 @@ typedef unsigned int XRef;
 typedef unsigned int XRef;
 
 #define XSet(xr, line, col, diag1, diag2)   xr = (diag1 << 31) | (diag2 << 30) | (col << 15) | line
-#define XGetL(xr)     (xr & 0x7f)
-#define XGetC(xr)     ((xr >> 15) & 0x7f)
+#define XGetL(xr)     (xr & 0x7fff)
+#define XGetC(xr)     ((xr >> 15) & 0x7fff)
 #define XIsOnD1(xr)   ((int) xr < 0)
 #define XIsOnD2(xr)   ((xr & 0x40000000) != 0)
 
@@ -127,6 +130,11 @@ static XRef *xref;
  *  The total cost = Sum |err_l[i]| + Sum |err_c[i]| + |err_d1| + |err_d2|
  *                   i=0              j=0
  *
+ *  With n = square_length and N = n*n, the lines whose sum exceeds avg
+ *  hold at most the N/2 largest values, so Sum |err_l[i]| <= N^2/4 (same
+ *  for the columns) and |err_d1|, |err_d2| < n^3/2. The total cost is thus
+ *  < n^4/2 + n^3 which fits an int for n <= MAX_SIDE.
+ *
  *  The projection on a variable at i, j:
  *  // err_var[i][j] = | err_l[i] + err_c[j] + F1(i,j) + F2(i,j) |  SLOW version
  *  err_var[i][j] = | err_l[i] | + | err_c[j] | + | F1(i,j) | + | F2(i,j) |
@@ -199,23 +207,28 @@ Solve(AdData *p_ad)
 int
 Cost_Of_Solution(int should_be_recorded)
 {
-  int k, r;
+  int i, j, k, r;
   int neg_avg = -avg;
+  int *row = sol;
+  int *ec = err_c;
 
   err_d1 = err_d2 = neg_avg;
 
-  memset(err_l, 0, sizeof(int) * square_length);
   memset(err_c, 0, sizeof(int) * square_length);
 
-  k = 0;
-  do
+				/* line by line: contiguous loops (vectorizable) */
+  for(i = 0; i < square_length; i++, row += square_length)
     {
-      XRef xr = xref[k];
+      int sum_l = 0;
+
+      for(j = 0; j < square_length; j++)
+	{
+	  sum_l += row[j];
+	  ec[j] += row[j];
+	}
 
-      err_l[XGetL(xr)] += sol[k];
-      err_c[XGetC(xr)] += sol[k];
+      err_l[i] = sum_l;
     }
-  while(++k < size);
 
   int k1 = 0, k2 = 0;
   do
@@ -279,6 +292,43 @@ Cost_On_Variable(int k)
 
 
 
+/*
+ *  COST_ON_ALL_VARIABLES
+ *
+ *  Evaluates the error on all variables (err[k] = Cost_On_Variable(k)).
+ *  Done line by line with contiguous (vectorizable) loops, then the
+ *  diagonals are added.
+ */
+
+#ifndef SLOW
+
+void
+Cost_On_All_Variables(int *err)
+{
+  int i, j;
+  int *e = err;
+  int *ec = err_c_abs;
+
+  for(i = 0; i < square_length; i++, e += square_length)
+    {
+      int el = err_l_abs[i];
+
+      for(j = 0; j < square_length; j++)
+	e[j] = el + ec[j];
+    }
+
+  for(i = 0; i < square_length; i++)
+    {
+      err[i * square_length_p1] += err_d1_abs;
+      err[(i + 1) * square_length_m1] += err_d2_abs;
+    }
+}
+
+#endif
+
+
+
+
 /*
  *  COST_IF_SWAP
  *
@@ -345,6 +395,101 @@ Cost_If_Swap(int current_cost, int k1, int k2)
 
 
 
+/*
+ *  COST_IF_MOVE
+ *
+ *  Evaluates the new total cost for a compound move: the swaps
+ *  (var[0],var[1]), (var[2],var[3])... (at most 4 swaps).
+ *  The value changes are first computed per cell, then gathered per
+ *  line/column/diagonal.
+ */
+
+#define MAX_MOVE_CELLS  8
+
+int
+Cost_If_Move(int current_cost, int *var, int nb_var)
+{
+  int cell[MAX_MOVE_CELLS], val[MAX_MOVE_CELLS];
+  int line[MAX_MOVE_CELLS], diff_l[MAX_MOVE_CELLS];
+  int col[MAX_MOVE_CELLS], diff_c[MAX_MOVE_CELLS];
+  int diff_d1 = 0, diff_d2 = 0;
+  int nb_cell = 0, nb_l = 0, nb_c = 0;
+  int k, m, p1, p2, x;
+  int r = current_cost;
+
+  for(k = 0; k < nb_var; k += 2)	/* apply the swaps on a local copy */
+    {
+      for(p1 = 0; p1 < nb_cell && cell[p1] != var[k]; p1++)
+	;
+      if (p1 == nb_cell)
+	{
+	  cell[nb_cell] = var[k];
+	  val[nb_cell++] = sol[var[k]];
+	}
+
+      for(p2 = 0; p2 < nb_cell && cell[p2] != var[k + 1]; p2++)
+	;
+      if (p2 == nb_cell)
+	{
+	  cell[nb_cell] = var[k + 1];
+	  val[nb_cell++] = sol[var[k + 1]];
+	}
+
+      x = val[p1];
+      val[p1] = val[p2];
+      val[p2] = x;
+    }
+
+  for(k = 0; k < nb_cell; k++)
+    {
+      XRef xr = xref[cell[k]];
+      int diff = val[k] - sol[cell[k]];
+
+      if (diff == 0)
+	continue;
+
+      x = XGetL(xr);
+      for(m = 0; m < nb_l && line[m] != x; m++)
+	;
+      if (m == nb_l)
+	{
+	  line[nb_l] = x;
+	  diff_l[nb_l++] = 0;
+	}
+      diff_l[m] += diff;
+
+      x = XGetC(xr);
+      for(m = 0; m < nb_c && col[m] != x; m++)
+	;
+      if (m == nb_c)
+	{
+	  col[nb_c] = x;
+	  diff_c[nb_c++] = 0;
+	}
+      diff_c[m] += diff;
+
+      if (XIsOnD1(xr))
+	diff_d1 += diff;
+
+      if (XIsOnD2(xr))
+	diff_d2 += diff;
+    }
+
+  for(m = 0; m < nb_l; m++)
+    AdjustL(r, diff_l[m], line[m]);
+
+  for(m = 0; m < nb_c; m++)
+    AdjustC(r, diff_c[m], col[m]);
+
+  AdjustD1(r, diff_d1);
+  AdjustD2(r, diff_d2);
+
+  return r;
+}
+
+
+
+
 /*
  *  EXECUTED_SWAP
  *
@@ -441,6 +586,12 @@ Init_Parameters(AdData *p_ad)
 {
   int square_length = p_ad->param;
 
+  if (square_length < 3 || square_length > MAX_SIDE)
+    {
+      fprintf(stderr, "the side of the square must be in 3..%d\n", MAX_SIDE);
+      exit(1);
+    }
+
   p_ad->size = square_length * square_length;
 
   int avg = square_length * (p_ad->size + 1) / 2;
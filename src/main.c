@@ -6,20 +6,67 @@
  *  main.c: benchmark main function
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE		/* for sched_setaffinity() */
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/utsname.h>
+
+#ifndef CELL
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/prctl.h>
+#endif
 
 #include "ad_solver.h"
+#include "stats.h"
+#include "walks.h"
 
 /*-----------*
  * Constants *
  *-----------*/
 
+#define FORMAT_TABLE   0	/* human readable (default) */
+#define FORMAT_JSONL   1	/* one JSON object per line and per run */
+#define FORMAT_CSV     2	/* one CSV line per run (with a header line) */
+
+#define MAX_REC_FIELDS 64
+
+#define Per_Sec(n, ns) ((ns) > 0 ? (double) (n) * 1e9 / (ns) : 0.0)
+
+#define Per_Iter(n, it) ((it) > 0 ? (double) (n) / (it) : 0.0) /* solved at iter 0 */
+
+#define MAX_WALKS      256	/* max nb of walks for the speedup prediction */
+
+#define SERVE_MAX_NBYTES   (1 << 30) /* max size of an instance sent to the server */
+
 /*-------*
  * Types *
  *-------*/
 
+typedef struct
+{
+  const char *name;
+  char type;			/* 'i'=integer, 'd'=double, 's'=string, 'v'=int vector */
+  const char *str;		/* string value */
+  const int *vec;		/* int vector value (val = nb of elements) */
+  long long val;		/* integer value */
+  double dval;			/* double value */
+} RecField;
+
 /*------------------*
  * Global variables *
  *------------------*/
@@ -31,6 +78,37 @@ static int disp_mode;
 static int check_valid;
 static int read_initial;	/* 0=no, 1=yes, 2=all threads use the same (CELL specific) */
 
+static int out_format;		/* FORMAT_TABLE, FORMAT_JSONL or FORMAT_CSV */
+static FILE *f_rec;		/* records (the real stdout) if out_format != FORMAT_TABLE */
+static char *prog_name;		/* name of the bench (basename of argv[0]) */
+static int seed0;		/* the initial random seed */
+static char *ttt_file;		/* time-to-target data file (or NULL) */
+
+static char *restart_policy_name[] = { "fixed", "luby", "geometric", "progress" };
+static int rec_header_done;	/* CSV header emitted ? */
+
+static char *serve_path;	/* server mode: "" = stdin/stdout, else a Unix socket (or NULL) */
+static AdData serve_opt;	/* server mode: the configuration before Init_Parameters */
+static char serve_param[512 + 32]; /* server mode: name of the current instance (records) */
+static char *serve_pb_name;	/* server mode: the problem of the command line */
+
+static AdPerfPhase perf_tot[AD_NB_PHASES]; /* counters per phase of all runs */
+static int perf_avail[AD_NB_COUNTERS];
+
+static char *perf_phase_name[AD_NB_PHASES] = {
+  "select var", "select swap", "exec swap", "reset", "restart"
+};
+
+static int nb_workers;		/* nb of processes for -b (1 = no fork) */
+int pin_workers;			/* pin each worker on a cpu ? */
+#ifndef CELL
+static RunStat *shared_stat;	/* [1..count] results (shared with workers) */
+static int *shared_next;	/* next run to do (shared with workers) */
+static char *run_ready;		/* [1..count] result received ? */
+static int worker_fd;		/* read end: indexes of finished runs */
+static pid_t *worker_pid;
+#endif
+
 
 extern int param_needed;	/* overwritten by benches if an argument is needed (> 0 = integer, < 0 = file name) */
 char *user_stat_name;		/* overwritten by benches if a user statistics is needed */
@@ -43,11 +121,30 @@ int (*user_stat_fct)(AdData *p_ad); /* overwritten by benches if a user statisti
 
 static void Set_Initial(AdData *p_ad);
 
-static void Verify_Sol(AdData *p_ad);
+static void Load_Profile(int *p_argc, char ***p_argv);
 
 static void Parse_Cmd_Line(int argc, char *argv[], AdData *p_ad);
 
-#define Div_Round_Up(x, y)   (((x) + (y) - 1) / (y))
+static void Init_Instance(AdData *p_ad);
+
+static void Emit_Record(AdData *p_ad, int run, RunStat *r);
+
+static void Display_Distribution(double *run_time, double *run_iter, int n);
+
+static void Add_Perf(RunStat *r);
+
+static void Display_Perf(void);
+
+#ifndef CELL
+static void Start_Workers(AdData *p_ad, int *run_seed);
+
+static RunStat *Wait_Run(int run);
+
+static void End_Workers(void);
+
+static void Serve(AdData *p_ad);
+
+#endif
 
 
 /* provided by each bench */
@@ -82,9 +179,14 @@ main(int argc, char *argv[])
 {
   static AdData data;		/* to be init with 0 (debug only) */
   AdData *p_ad = &data;
-  int i, user_stat = 0;
+  int i;
+  int *run_seed;
+  double *run_time, *run_iter;	/* of solved runs (for the distribution) */
+  long long wall_ns0, wall_ns, cpu_ns = 0;
+  long long nb_iter_all = 0, nb_swap_all = 0;
+  int nb_solved = 0;
+  RunStat run_stat, *r = &run_stat;
 
-  double time_one0, time_one;
   double nb_same_var_by_iter, nb_same_var_by_iter_tot;
 
   int    nb_iter_cum;
@@ -111,24 +213,70 @@ main(int argc, char *argv[])
   char buff[256], str[32];
 
 
+  if (!ad_no_select_pb_fct)	/* adsolve PROBLEM ...: then as the bench PROBLEM */
+    {
+      if ((argv[1] = Select_Problem(argv[1])) == NULL)
+	exit(1);
+      argc--;
+      argv++;
+    }
+
+  Load_Profile(&argc, &argv);
   Parse_Cmd_Line(argc, argv, p_ad);
 
+  if (serve_path)		/* answers are records, no initial config on stdin */
+    {
+      if (out_format == FORMAT_TABLE)
+	out_format = FORMAT_JSONL;
+      read_initial = 0;
+    }
+
+#ifndef CELL
+  if (coord_addr && nb_walks <= 0)
+    {
+      fprintf(stderr, "--coord needs --walks=NB\n");
+      exit(1);
+    }
+  if (portfolio && worker_addr)	/* the coordinator sends the configurations */
+    portfolio = NULL;
+  if (portfolio && nb_walks <= 0 && strcmp(portfolio, "random") == 0)
+    {
+      fprintf(stderr, "--portfolio=random needs --walks=NB\n");
+      exit(1);
+    }
+  if (serve_path && (nb_walks > 0 || worker_addr))
+    {
+      fprintf(stderr, "--serve cannot be used with --walks or --worker\n");
+      exit(1);
+    }
+  if (nb_walks > 0 || worker_addr || portfolio)
+    read_initial = 0;
+#endif
+
+  if (out_format != FORMAT_TABLE)	/* records on stdout, all the rest on stderr */
+    {
+      fflush(stdout);
+      if ((f_rec = fdopen(dup(1), "w")) == NULL || dup2(2, 1) < 0)
+	{
+	  perror("stdout");
+	  exit(1);
+	}
+      setvbuf(f_rec, NULL, _IOLBF, 0);
+    }
+
   if (p_ad->seed < 0)
     p_ad->seed = Randomize();
   else
     Randomize_Seed(p_ad->seed);
+  seed0 = p_ad->seed;
 
-  p_ad->nb_var_to_reset = -1;
-  p_ad->do_not_init = 0;
-  p_ad->actual_value = NULL;
-  p_ad->base_value = 0;
-  p_ad->break_nl = 0;
-  /* defaults */
-
-  Init_Parameters(p_ad);
+#ifndef CELL
+  if (portfolio)		/* sets nb_walks if not given */
+    Load_Portfolio(p_ad);
+#endif
 
-  if (p_ad->reset_limit >= p_ad->size)
-    p_ad->reset_limit = p_ad->size - 1;
+  serve_opt = *p_ad;
+  Init_Instance(p_ad);
 
   setvbuf(stdout, NULL, _IOLBF, 0);
   //setlinebuf(stdout);
@@ -139,19 +287,6 @@ main(int argc, char *argv[])
   if (p_ad->log_file && !ad_has_log_file)
     printf("Warning ad_solver is not compiled with log file support\n");
 
-  p_ad->size_in_bytes = p_ad->size * sizeof(int);
-  p_ad->sol = malloc(p_ad->size_in_bytes);
-
-  if (p_ad->nb_var_to_reset == -1)
-    {
-      p_ad->nb_var_to_reset = Div_Round_Up(p_ad->size * p_ad->reset_percent, 100);
-      if (p_ad->nb_var_to_reset < 2)
-	{
-	  p_ad->nb_var_to_reset = 2;
-	  printf("increasing nb var to reset since too small, now = %d\n", p_ad->nb_var_to_reset);
-	}
-    }
-
   printf("problem size: %d\n", p_ad->size);
   printf("current random seed used: %d\n", p_ad->seed);
   if (p_ad->optim_pb)
@@ -176,18 +311,55 @@ main(int argc, char *argv[])
     printf("%d %%\n", p_ad->prob_select_loc_min);
   else
     printf("not used\n");
-  printf("abort when %d iterations are reached "
-	 "and restart at most %d times\n",
-	 p_ad->restart_limit, p_ad->restart_max);
+  if (p_ad->conflict_set && !p_ad->exhaustive)
+    printf("variable to swap selected among variables in conflict\n");
+  if (p_ad->move_tries > 0)
+    printf("%d compound moves (3-cycle/double swap) tried when no swap improves\n", p_ad->move_tries);
+  if (p_ad->adaptive)
+    printf("freeze and reset parameters adapted during the run (from these initial values)\n");
+  switch(p_ad->restart_policy)
+    {
+    case AD_RESTART_LUBY:
+      printf("abort when %d * Luby(run) iterations are reached ", p_ad->restart_limit);
+      break;
+    case AD_RESTART_GEOMETRIC:
+      printf("abort when %d iterations (+%d %% at each restart) are reached ", p_ad->restart_limit, p_ad->restart_grow);
+      break;
+    case AD_RESTART_PROGRESS:
+      printf("abort when %d iterations are done without improvement ", p_ad->restart_limit);
+      break;
+    default:
+      printf("abort when %d iterations are reached ", p_ad->restart_limit);
+    }
+  printf("and restart at most %d times%s\n", p_ad->restart_max,
+	 (p_ad->restart_from_best) ? " (from the best configuration)" : "");
+
+#ifndef CELL
+  if (serve_path)
+    Serve(p_ad);
+
+  if (worker_addr)
+    Walk_Workers(p_ad);
+
+  if (nb_walks > 0)
+    printf("%d walks per run (%s%s)\n", nb_walks,
+	   (coord_addr) ? "workers connecting to " : "local processes",
+	   (coord_addr) ? coord_addr : "");
+  if (walk_config)
+    for(i = 0; i < nb_walks; i++)
+      printf("  walk %3d: %s\n", i, (*walk_config[i]) ? walk_config[i] : "(command line)");
+#endif
 
   if (count <= 0)
     {
-      Set_Initial(p_ad);
-
-      p_ad->seed = Random(65536);
-      time_one0 = (double) User_Time();
-      Solve(p_ad);
-      time_one = ((double) User_Time() - time_one0) / 1000;
+#ifndef CELL
+      if (nb_walks > 0)
+	Multi_Walk(p_ad, p_ad->seed, r);
+      else
+#endif
+	Do_Run(p_ad, p_ad->seed, r);
+      if (f_rec)
+	Emit_Record(p_ad, 1, r);
 
       if (p_ad->exhaustive)
 	printf("exhaustive search\n");
@@ -195,7 +367,8 @@ main(int argc, char *argv[])
       if (count < 0)
 	Display_Solution(p_ad);
 
-      Verify_Sol(p_ad);
+      if (nb_walks == 0)	/* else checked by the worker */
+	Verify_Sol(p_ad);
 
       if (!TARGET_REACHED(p_ad))
 	{
@@ -208,34 +381,62 @@ main(int argc, char *argv[])
 
       if (count == 0)
 	{
-	  nb_same_var_by_iter = (double) p_ad->nb_same_var / p_ad->nb_iter;
-	  nb_same_var_by_iter_tot = (double) p_ad->nb_same_var_tot / p_ad->nb_iter_tot;
+	  nb_same_var_by_iter = Per_Iter(p_ad->nb_same_var, p_ad->nb_iter);
+	  nb_same_var_by_iter_tot = Per_Iter(p_ad->nb_same_var_tot, p_ad->nb_iter_tot);
 
-	  printf("%6d %9d %9.2f %9d %9d %9d %9d %9.1f %9d %9d %9d %9d %9.1f", 
-		 p_ad->nb_restart, p_ad->total_cost, time_one, 
+	  printf("%6d %9d %9.4f %9d %9d %9d %9d %9.1f %9d %9d %9d %9d %9.1f", 
+		 p_ad->nb_restart, p_ad->total_cost, r->time, 
 		 p_ad->nb_iter, p_ad->nb_local_min, p_ad->nb_swap, 
 		 p_ad->nb_reset, nb_same_var_by_iter,
 		 p_ad->nb_iter_tot, p_ad->nb_local_min_tot, p_ad->nb_swap_tot, 
 		 p_ad->nb_reset_tot, nb_same_var_by_iter_tot);
 	  if (user_stat_fct)
-	    printf("%9d", (*user_stat_fct)(p_ad));
+	    printf("%9d", r->user_stat);
 	  printf("\n");
 	}
       else
 	{
-	  printf("in %.2f secs (restarts: %d, cost: %d, iters: %d, loc min: %d, swaps: %d, resets: %d", 
-		 time_one, p_ad->nb_restart, p_ad->total_cost, 
+	  printf("in %.4f secs (wall: %.4f secs, restarts: %d, cost: %d, iters: %d, loc min: %d, swaps: %d, resets: %d", 
+		 r->time, r->wall_ns / 1e9, p_ad->nb_restart, p_ad->total_cost, 
 		 p_ad->nb_iter_tot, p_ad->nb_local_min_tot, 
 		 p_ad->nb_swap_tot, p_ad->nb_reset_tot);
 	  if (user_stat_name && user_stat_fct)
-	    printf(", %s: %d", user_stat_name,  (*user_stat_fct)(p_ad));
+	    printf(", %s: %d", user_stat_name, r->user_stat);
 
-	  printf(")\n");
+	  printf(", %.0f iters/s, %.0f swaps/s)\n",
+		 Per_Sec(r->nb_iter_tot, r->cpu_ns), Per_Sec(r->nb_swap_tot, r->cpu_ns));
 	}
 
+      if (walk_config)
+	printf("winning configuration (walk %d): %s\n", r->walk,
+	       (*walk_opt[r->walk]) ? walk_opt[r->walk] : "(command line)");
+
+      Add_Perf(r);
+      Display_Perf();
+
       return 0;
     }
 
+				/* seeds drawn before any run: reproducible whatever nb_workers */
+  run_seed = malloc((count + 1) * sizeof(int));
+  run_time = malloc(count * sizeof(double));
+  run_iter = malloc(count * sizeof(double));
+  if (run_seed == NULL || run_time == NULL || run_iter == NULL)
+    {
+      fprintf(stderr, "%s:%d malloc failed\n", __FILE__, __LINE__);
+      exit(1);
+    }
+  for(i = 1; i <= count; i++)
+    run_seed[i] = Run_Seed();
+
+  if (read_initial || nb_walks > 0) /* initial configuration on stdin or runs already parallel */
+    nb_workers = 1;
+  if (nb_workers > count)
+    nb_workers = count;
+  if (nb_workers > 1)
+    printf("%d runs in parallel (%d processes%s)\n", count, nb_workers,
+	   (pin_workers) ? ", pinned to cpus" : "");
+
   putchar('\n');
 
 
@@ -283,104 +484,121 @@ main(int argc, char *argv[])
   nb_same_var_by_iter_tot_max = 0;
 
 
+  wall_ns0 = Real_Time_Ns();
+
+#ifndef CELL
+  if (nb_workers > 1)
+    Start_Workers(p_ad, run_seed);
+#endif
+
   for(i = 1; i <= count; i++)
     {
-      Set_Initial(p_ad);
+#ifndef CELL
+      if (nb_workers > 1)
+	r = Wait_Run(i);
+      else if (nb_walks > 0)
+	Multi_Walk(p_ad, run_seed[i], r);
+      else
+#endif
+	Do_Run(p_ad, run_seed[i], r);
 
+      if (f_rec)
+	Emit_Record(p_ad, i, r);
 
+      cpu_ns += r->cpu_ns;
+      Add_Perf(r);
+      nb_iter_all += r->nb_iter_tot;
+      nb_swap_all += r->nb_swap_tot;
 
-      p_ad->seed = Random(65536);
-      //if (i == 3) printf("\n\n\nseed ================ %d\n", p_ad->seed);
-      time_one0 = (double) User_Time();
-      Solve(p_ad);
-      time_one = ((double) User_Time() - time_one0) / 1000;
+      if (r->reached)
+	{
+	  run_time[nb_solved] = ((nb_walks > 0) ? r->wall_ns : r->cpu_ns) / 1e9;
+	  run_iter[nb_solved++] = r->nb_iter_tot;
+	}
 
       if (disp_mode == 2 && nb_restart_cum > 0)
 	printf("\033[A\033[K");
       printf("\033[A\033[K\033[A\033[256D");
 
+      if (nb_workers <= 1 && nb_walks == 0)
+	Verify_Sol(p_ad);
 
-      Verify_Sol(p_ad);
 
-      if (user_stat_fct)
-	user_stat = (*user_stat_fct)(p_ad);
+      nb_same_var_by_iter = Per_Iter(r->nb_same_var, r->nb_iter);
+      nb_same_var_by_iter_tot = Per_Iter(r->nb_same_var_tot, r->nb_iter_tot);
 
-
-      nb_same_var_by_iter = (double) p_ad->nb_same_var / p_ad->nb_iter;
-      nb_same_var_by_iter_tot = (double) p_ad->nb_same_var_tot / p_ad->nb_iter_tot;
-
-      total_cost_cum += p_ad->total_cost;
-      nb_restart_cum += p_ad->nb_restart;
-      time_cum += time_one;
-      nb_iter_cum += p_ad->nb_iter;
-      nb_local_min_cum += p_ad->nb_local_min;
-      nb_swap_cum += p_ad->nb_swap;
-      nb_reset_cum += p_ad->nb_reset;
+      total_cost_cum += r->total_cost;
+      nb_restart_cum += r->nb_restart;
+      time_cum += r->time;
+      nb_iter_cum += r->nb_iter;
+      nb_local_min_cum += r->nb_local_min;
+      nb_swap_cum += r->nb_swap;
+      nb_reset_cum += r->nb_reset;
       nb_same_var_by_iter_cum += nb_same_var_by_iter;
-      user_stat_cum += user_stat;
+      user_stat_cum += r->user_stat;
 
-      nb_iter_tot_cum += p_ad->nb_iter_tot;
-      nb_local_min_tot_cum += p_ad->nb_local_min_tot;
-      nb_swap_tot_cum += p_ad->nb_swap_tot;
-      nb_reset_tot_cum += p_ad->nb_reset_tot;
+      nb_iter_tot_cum += r->nb_iter_tot;
+      nb_local_min_tot_cum += r->nb_local_min_tot;
+      nb_swap_tot_cum += r->nb_swap_tot;
+      nb_reset_tot_cum += r->nb_reset_tot;
       nb_same_var_by_iter_tot_cum += nb_same_var_by_iter_tot;
 
-      if (total_cost_min > p_ad->total_cost)
-	total_cost_min = p_ad->total_cost;
-      if (nb_restart_min > p_ad->nb_restart)
-	nb_restart_min = p_ad->nb_restart;
-      if (time_min > time_one)
-	time_min = time_one;
-      if (nb_iter_tot_min > p_ad->nb_iter_tot)
-	nb_iter_tot_min = p_ad->nb_iter_tot;
-      if (nb_local_min_tot_min > p_ad->nb_local_min_tot)
-	nb_local_min_tot_min = p_ad->nb_local_min_tot;
-      if (nb_swap_tot_min > p_ad->nb_swap_tot)
-	nb_swap_tot_min = p_ad->nb_swap_tot;
-      if (nb_reset_tot_min > p_ad->nb_reset_tot)
-	nb_reset_tot_min = p_ad->nb_reset_tot;
+      if (total_cost_min > r->total_cost)
+	total_cost_min = r->total_cost;
+      if (nb_restart_min > r->nb_restart)
+	nb_restart_min = r->nb_restart;
+      if (time_min > r->time)
+	time_min = r->time;
+      if (nb_iter_tot_min > r->nb_iter_tot)
+	nb_iter_tot_min = r->nb_iter_tot;
+      if (nb_local_min_tot_min > r->nb_local_min_tot)
+	nb_local_min_tot_min = r->nb_local_min_tot;
+      if (nb_swap_tot_min > r->nb_swap_tot)
+	nb_swap_tot_min = r->nb_swap_tot;
+      if (nb_reset_tot_min > r->nb_reset_tot)
+	nb_reset_tot_min = r->nb_reset_tot;
       if (nb_same_var_by_iter_tot_min > nb_same_var_by_iter_tot)
 	nb_same_var_by_iter_tot_min = nb_same_var_by_iter_tot;
-      if (user_stat_min > user_stat)
-	user_stat_min = user_stat;
-
-      if (total_cost_max < p_ad->total_cost)
-	total_cost_max = p_ad->total_cost;
-      if (nb_restart_max < p_ad->nb_restart)
-	nb_restart_max = p_ad->nb_restart;
-      if (time_max < time_one)
-	time_max = time_one;
-      if (nb_iter_tot_max < p_ad->nb_iter_tot)
-	nb_iter_tot_max = p_ad->nb_iter_tot;
-      if (nb_local_min_tot_max < p_ad->nb_local_min_tot)
-	nb_local_min_tot_max = p_ad->nb_local_min_tot;
-      if (nb_swap_tot_max < p_ad->nb_swap_tot)
-	nb_swap_tot_max = p_ad->nb_swap_tot;
-      if (nb_reset_tot_max < p_ad->nb_reset_tot)
-	nb_reset_tot_max = p_ad->nb_reset_tot;
+      if (user_stat_min > r->user_stat)
+	user_stat_min = r->user_stat;
+
+      if (total_cost_max < r->total_cost)
+	total_cost_max = r->total_cost;
+      if (nb_restart_max < r->nb_restart)
+	nb_restart_max = r->nb_restart;
+      if (time_max < r->time)
+	time_max = r->time;
+      if (nb_iter_tot_max < r->nb_iter_tot)
+	nb_iter_tot_max = r->nb_iter_tot;
+      if (nb_local_min_tot_max < r->nb_local_min_tot)
+	nb_local_min_tot_max = r->nb_local_min_tot;
+      if (nb_swap_tot_max < r->nb_swap_tot)
+	nb_swap_tot_max = r->nb_swap_tot;
+      if (nb_reset_tot_max < r->nb_reset_tot)
+	nb_reset_tot_max = r->nb_reset_tot;
       if (nb_same_var_by_iter_tot_max < nb_same_var_by_iter_tot)
 	nb_same_var_by_iter_tot_max = nb_same_var_by_iter_tot;
-      if (user_stat_max < user_stat)
-	user_stat_max = user_stat;
+      if (user_stat_max < r->user_stat)
+	user_stat_max = r->user_stat;
 
 
       switch(disp_mode)
 	{
 	case 0:			/* only last iter counters */
 	case 2:			/* last iter followed by restart if needed */
-	  printf("|%4d |%6d |%9d%c|%9.2f |%9d |%9d |%9d |%9d |%9.1f |",		 
-		 i, p_ad->nb_restart, p_ad->total_cost, TARGET_REACHED(p_ad) ? ' ' : '*', 
-		 time_one, p_ad->nb_iter, p_ad->nb_local_min, p_ad->nb_swap,
-		 p_ad->nb_reset, nb_same_var_by_iter);
+	  printf("|%4d |%6d |%9d%c|%9.4f |%9d |%9d |%9d |%9d |%9.1f |",		 
+		 i, r->nb_restart, r->total_cost, r->reached ? ' ' : '*', 
+		 r->time, r->nb_iter, r->nb_local_min, r->nb_swap,
+		 r->nb_reset, nb_same_var_by_iter);
 	  if (user_stat_fct)
-	    printf("%9d |", user_stat);
+	    printf("%9d |", r->user_stat);
 	  printf("\n");
 
-	  if (disp_mode == 2 && p_ad->nb_restart > 0) 
+	  if (disp_mode == 2 && r->nb_restart > 0) 
 	    {
 	      printf("|     |       |          |          |%9d |%9d |%9d |%9d |%9.1f |",
-		     p_ad->nb_iter_tot, p_ad->nb_local_min_tot, p_ad->nb_swap_tot,
-		     p_ad->nb_reset_tot, nb_same_var_by_iter_tot);
+		     r->nb_iter_tot, r->nb_local_min_tot, r->nb_swap_tot,
+		     r->nb_reset_tot, nb_same_var_by_iter_tot);
 	      if (user_stat_fct)
 		printf("          |");
 	      printf("\n");
@@ -388,7 +606,7 @@ main(int argc, char *argv[])
 
 	  printf("%s", buff);
 
-	  printf("| avg |%6d |%9d |%9.2f |%9d |%9d |%9d |%9d |%9.1f |",
+	  printf("| avg |%6d |%9d |%9.4f |%9d |%9d |%9d |%9d |%9.1f |",
 		 nb_restart_cum / i, total_cost_cum / i, time_cum / i,
 		 nb_iter_cum / i, nb_local_min_cum / i, nb_swap_cum / i,
 		 nb_reset_cum / i, nb_same_var_by_iter_cum / i);
@@ -411,17 +629,17 @@ main(int argc, char *argv[])
 	  break;
 
 	case 1:			/* only total (restart + last iter) counters */
-	  printf("|%4d |%6d |%9d%c|%9.2f |%9d |%9d |%9d |%9d |%9.1f |",
-		 i, p_ad->nb_restart, p_ad->total_cost, TARGET_REACHED(p_ad) ? ' ' : '*',
-		 time_one, p_ad->nb_iter_tot, p_ad->nb_local_min_tot, p_ad->nb_swap_tot,
-		 p_ad->nb_reset_tot, nb_same_var_by_iter_tot);
+	  printf("|%4d |%6d |%9d%c|%9.4f |%9d |%9d |%9d |%9d |%9.1f |",
+		 i, r->nb_restart, r->total_cost, r->reached ? ' ' : '*',
+		 r->time, r->nb_iter_tot, r->nb_local_min_tot, r->nb_swap_tot,
+		 r->nb_reset_tot, nb_same_var_by_iter_tot);
 	  if (user_stat_fct)
-	    printf("%9d |", user_stat);
+	    printf("%9d |", r->user_stat);
 	  printf("\n");
 
 	  printf("%s", buff);
 
-	  printf("| avg |%6d |%9d |%9.2f |%9d |%9d |%9d |%9d |%9.1f |",
+	  printf("| avg |%6d |%9d |%9.4f |%9d |%9d |%9d |%9d |%9.1f |",
 		 nb_restart_cum / i, total_cost_cum / i, time_cum / i,
 		 nb_iter_tot_cum / i, nb_local_min_tot_cum / i, nb_swap_tot_cum / i,
 		 nb_reset_tot_cum / i, nb_same_var_by_iter_tot_cum / i);
@@ -434,10 +652,17 @@ main(int argc, char *argv[])
 	}
     }
 
+#ifndef CELL
+  if (nb_workers > 1)
+    End_Workers();
+#endif
+
+  wall_ns = Real_Time_Ns() - wall_ns0;
+
   if (count <= 0)
     return 0;
 
-  printf("| min |%6d |%9d |%9.2f |%9d |%9d |%9d |%9d |%9.1f |",
+  printf("| min |%6d |%9d |%9.4f |%9d |%9d |%9d |%9d |%9.1f |",
 	 nb_restart_min, total_cost_min, time_min,
 	 nb_iter_tot_min, nb_local_min_tot_min, nb_swap_tot_min,
 	 nb_reset_tot_min, nb_same_var_by_iter_tot_min);
@@ -445,7 +670,7 @@ main(int argc, char *argv[])
     printf("%9d |", user_stat_min);
   printf("\n");
 
-  printf("| max |%6d |%9d |%9.2f |%9d |%9d |%9d |%9d |%9.1f |",
+  printf("| max |%6d |%9d |%9.4f |%9d |%9d |%9d |%9d |%9.1f |",
 	 nb_restart_max, total_cost_max, time_max,
 	 nb_iter_tot_max, nb_local_min_tot_max, nb_swap_tot_max,
 	 nb_reset_tot_max, nb_same_var_by_iter_tot_max);
@@ -453,6 +678,23 @@ main(int argc, char *argv[])
     printf("%9d |", user_stat_max);
   printf("\n");
 
+  printf("\nwall time: %.4f secs, cpu time of the runs: %.4f secs (cpu/wall: %.2f)\n",
+	 wall_ns / 1e9, cpu_ns / 1e9, (wall_ns > 0) ? (double) cpu_ns / wall_ns : 0.0);
+  printf("throughput of a walk: %.0f iters/s, %.0f swaps/s\n",
+	 Per_Sec(nb_iter_all, cpu_ns), Per_Sec(nb_swap_all, cpu_ns));
+
+  if (nb_solved < count)
+    printf("\n%d runs out of %d did not reach the target (not in the distribution)\n",
+	   count - nb_solved, count);
+
+  Display_Distribution(run_time, run_iter, nb_solved);
+
+#ifndef CELL
+  if (walk_config)
+    Display_Portfolio();
+#endif
+
+  Display_Perf();
 
 
 
@@ -461,131 +703,1244 @@ main(int argc, char *argv[])
 
 
 
-void
-Set_Initial(AdData *p_ad)
+/*
+ *  INIT_INSTANCE
+ *
+ *  Completes the configuration for the instance p_ad->param(_file):
+ *  Init_Parameters then the derived parameters. The solution vector is
+ *  only reallocated for a bigger instance (server mode).
+ */
+static void
+Init_Instance(AdData *p_ad)
 {
-  int i;
-  switch (read_initial)
-    {
-    case 0:
-      break;
+  static int *sol = NULL;
+  static int sol_size = 0;
 
-    case 1:
-      printf("enter the initial configuration:\n");
-      for(i = 0; i < p_ad->size; i++)
-	if (scanf("%d", &p_ad->sol[i])) /* avoid gcc warning warn_unused_result */
-	  {}
-      getchar();		/* the last \n */
-      Display_Solution(p_ad);
-      p_ad->do_not_init = 1;
-      Check_Init_Configuration(p_ad);
-      break;
+  p_ad->nb_var_to_reset = -1;
+  p_ad->do_not_init = 0;
+  p_ad->actual_value = NULL;
+  p_ad->base_value = 0;
+  p_ad->break_nl = 0;
+  /* defaults */
 
-    case 2:
-      p_ad->do_not_init = 1;
-      Set_Init_Configuration(p_ad);
-      break;
+  Init_Parameters(p_ad);
+
+  if (p_ad->reset_limit >= p_ad->size)
+    p_ad->reset_limit = p_ad->size - 1;
+
+  if (p_ad->move_tries < 0)	/* no default given by the bench */
+    p_ad->move_tries = 0;
+
+  p_ad->size_in_bytes = p_ad->size * sizeof(int);
+  if (p_ad->size > sol_size)
+    {
+      free(sol);
+      if ((sol = malloc(p_ad->size_in_bytes)) == NULL)
+	{
+	  fprintf(stderr, "%s:%d malloc failed\n", __FILE__, __LINE__);
+	  exit(1);
+	}
+      sol_size = p_ad->size;
     }
+  p_ad->sol = sol;
 
-#if defined(DEBUG) && (DEBUG & 1)
-  if (p_ad->do_not_init)
+  if (p_ad->nb_var_to_reset == -1)
     {
-      printf("++++++++++ values to pass to threads (do_not_init=1)\n");
-      Display_Solution(p_ad);
-      printf("+++++++++++++++++++++++++++\n");
+      p_ad->nb_var_to_reset = Div_Round_Up(p_ad->size * p_ad->reset_percent, 100);
+      if (p_ad->nb_var_to_reset < 2)
+	{
+	  p_ad->nb_var_to_reset = 2;
+	  printf("increasing nb var to reset since too small, now = %d\n", p_ad->nb_var_to_reset);
+	}
     }
-#endif
 }
 
 
 
 
-static void
-Verify_Sol(AdData *p_ad)
+/*
+ *  DO_RUN
+ *
+ *  Runs the solver once with a given seed and records the result.
+ */
+void
+Do_Run(AdData *p_ad, int seed, RunStat *r)
 {
-  if (!check_valid)
-    return;
+  long long wall_ns0, cpu_ns0;
+  int ph, k;
+
+  Randomize_Seed(seed);
+  p_ad->seed = seed;
+
+  Set_Initial(p_ad);
+
+  if (ad_has_perf)		/* ad_perf[] is cumulative: r->perf = difference */
+    memcpy(r->perf, ad_perf, sizeof(r->perf));
+
+  wall_ns0 = Real_Time_Ns();
+  cpu_ns0 = Thread_CPU_Time_Ns();
+  Solve(p_ad);
+  r->cpu_ns = Thread_CPU_Time_Ns() - cpu_ns0;
+  r->wall_ns = Real_Time_Ns() - wall_ns0;
+  r->time = r->cpu_ns / 1e9;
+
+  r->seed = seed;
+  r->walk = -1;
+  r->reached = TARGET_REACHED(p_ad);
+  r->total_cost = p_ad->total_cost;
+  r->nb_restart = p_ad->nb_restart;
+  r->nb_iter = p_ad->nb_iter;
+  r->nb_swap = p_ad->nb_swap;
+  r->nb_reset = p_ad->nb_reset;
+  r->nb_local_min = p_ad->nb_local_min;
+  r->nb_same_var = p_ad->nb_same_var;
+  r->nb_iter_tot = p_ad->nb_iter_tot;
+  r->nb_swap_tot = p_ad->nb_swap_tot;
+  r->nb_reset_tot = p_ad->nb_reset_tot;
+  r->nb_local_min_tot = p_ad->nb_local_min_tot;
+  r->nb_same_var_tot = p_ad->nb_same_var_tot;
+  r->user_stat = (user_stat_fct) ? (*user_stat_fct)(p_ad) : 0;
+
+  if (ad_has_perf)
+    {
+      for(ph = 0; ph < AD_NB_PHASES; ph++)
+	{
+	  r->perf[ph].nb_calls = ad_perf[ph].nb_calls - r->perf[ph].nb_calls;
+	  for(k = 0; k < AD_NB_COUNTERS; k++)
+	    r->perf[ph].val[k] = ad_perf[ph].val[k] - r->perf[ph].val[k];
+	}
+      memcpy(r->perf_avail, ad_perf_avail, sizeof(r->perf_avail));
+    }
+}
 
-  int c = Cost_Of_Solution(0);
-  if (c != p_ad->total_cost)
-    printf("\n*** ERROR real cost:%d != returned cost: %d\n", c, p_ad->total_cost);
 
-  if (p_ad->total_cost == 0 && !Check_Solution(p_ad))
-    printf("*** Erroneous Solution !!!\n");
-}
 
 
+#ifndef CELL
+
+/*
+ *  PIN_TO_CPU
+ *
+ *  Pins the calling process on the nth cpu it is allowed to run on.
+ */
+void
+Pin_To_Cpu(int n)
+{
+#ifdef __linux__
+  cpu_set_t allowed, set;
+  int cpu, nb;
+
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0 ||
+      (nb = CPU_COUNT(&allowed)) == 0)
+    return;
+
+  n %= nb;
+  for(cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    if (CPU_ISSET(cpu, &allowed) && n-- == 0)
+      break;
+
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  if (sched_setaffinity(0, sizeof(set), &set) != 0)
+    perror("sched_setaffinity");
+#endif
+}
 
 
-#define L(msg) fprintf(stderr, msg "\n")
 
 
 /*
- *  PARSE_CMD_LINE
+ *  START_WORKERS
  *
+ *  Forks nb_workers processes sharing the runs 1..count. Each worker
+ *  takes the next run to do (shared counter), stores its result in a
+ *  shared array and sends the run index on a pipe. The seed of run i is
+ *  always run_seed[i] so the results do not depend on nb_workers.
  */
 static void
-Parse_Cmd_Line(int argc, char *argv[], AdData *p_ad)
+Start_Workers(AdData *p_ad, int *run_seed)
 {
-  int param_read = 0;
-  int i;
-
-  nb_threads = 1;
-
-  count = -1;
-  disp_mode = 1;
-  check_valid = 0;
-  read_initial = 0;
+  int fd[2];
+  int w, k;
+  size_t sz = (count + 1) * sizeof(RunStat) + sizeof(int);
+  void *shm;
+
+  shm = mmap(NULL, sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  run_ready = calloc(count + 1, 1);
+  worker_pid = malloc(nb_workers * sizeof(pid_t));
+  if (shm == MAP_FAILED || run_ready == NULL || worker_pid == NULL)
+    {
+      fprintf(stderr, "%s:%d malloc failed\n", __FILE__, __LINE__);
+      exit(1);
+    }
+  shared_stat = (RunStat *) shm; /* [0] unused */
+  shared_next = (int *) (shared_stat + count + 1);
+  *shared_next = 1;
 
-  p_ad->param = -1;
-  p_ad->seed = -1;
-  p_ad->debug = 0;
-  p_ad->log_file = NULL;
-  p_ad->prob_select_loc_min = -1;
-  p_ad->freeze_loc_min = -1;
-  p_ad->freeze_swap = -1;
-  p_ad->reset_limit = -1;
-  p_ad->reset_percent = -1;
-  p_ad->restart_limit = -1;
-  p_ad->restart_max = -1;
-  p_ad->exhaustive = 0;
-  p_ad->first_best = 0;
-  p_ad->optim_pb = 0;
-  p_ad->target_cost = 0;
+  if (pipe(fd) != 0)
+    {
+      perror("pipe");
+      exit(1);
+    }
 
+  fflush(stdout);
+  fflush(stderr);
+  if (f_rec)
+    fflush(f_rec);
 
-  for(i = 1; i < argc; i++)
+  for(w = 0; w < nb_workers; w++)
     {
-      if (argv[i][0] == '-')
+      if ((worker_pid[w] = fork()) < 0)
 	{
-	  switch(argv[i][1])
+	  perror("fork");
+	  exit(1);
+	}
+
+      if (worker_pid[w] == 0)	/* the worker */
+	{
+	  close(fd[0]);
+	  if (pin_workers)
+	    Pin_To_Cpu(w);
+
+	  while((k = __sync_fetch_and_add(shared_next, 1)) <= count)
 	    {
-	    case 'i':
-	      read_initial = 1;
-	      continue;
+	      Do_Run(p_ad, run_seed[k], &shared_stat[k]);
+	      Verify_Sol(p_ad);
+	      fflush(stdout);
+	      if (write(fd[1], &k, sizeof(k)) != sizeof(k))
+		_exit(1);
+	    }
+	  _exit(0);
+	}
+    }
 
-	    case 'D':
-	      if (++i >= argc)
-		{
-		  L("debug level expected");
-		  exit(1);
-		}
-	      p_ad->debug = atoi(argv[i]);
-	      continue;
+  close(fd[1]);
+  worker_fd = fd[0];
+}
 
-	    case 's':
-	      if (++i >= argc)
-		{
-		  L("random seed expected");
-		  exit(1);
-		}
-	      p_ad->seed = atoi(argv[i]);
-	      continue;
 
-	    case 'L':
-	      if (++i >= argc)
-		{
-		  L("log file name expected");
+
+
+/*
+ *  WAIT_RUN
+ *
+ *  Waits until the result of a run is available (results are
+ *  displayed in the run order, whatever the order they are computed).
+ */
+static RunStat *
+Wait_Run(int run)
+{
+  int k;
+
+  while(!run_ready[run])
+    {
+      if (read(worker_fd, &k, sizeof(k)) != sizeof(k) || k < 1 || k > count)
+	{
+	  fprintf(stderr, "\n*** a worker died before run %d was done\n", run);
+	  exit(1);
+	}
+      run_ready[k] = 1;
+    }
+
+  return &shared_stat[run];
+}
+
+
+
+
+/*
+ *  END_WORKERS
+ *
+ *  Waits for the termination of the workers.
+ */
+static void
+End_Workers(void)
+{
+  int w;
+
+  for(w = 0; w < nb_workers; w++)
+    waitpid(worker_pid[w], NULL, 0);
+
+  close(worker_fd);
+  free(worker_pid);
+  free(run_ready);
+}
+
+
+
+
+/*
+ *  SERVER MODE (--serve)
+ *
+ *  A persistent process solves a stream of requests. A request is a
+ *  header line followed by an instance:
+ *
+ *    SEED TIME_MS NBYTES [delta | problem=NAME [.SUFFIX]]\n
+ *    NBYTES bytes: the instance (contents of the problem file)
+ *
+ *  SEED < 0: a seed is drawn from the master seed, TIME_MS = 0: no time
+ *  limit (else the run is stopped after TIME_MS msecs), NBYTES = 0: the
+ *  current instance (initially the one given on the command line, the
+ *  others are in the same format, e.g. .dat or .smp). NBYTES is at most
+ *  SERVE_MAX_NBYTES. Only problems defining Free_Problem can load other
+ *  instances.
+ *
+ *  An instance is not written to a file: the problem reads it from
+ *  memory (its loader uses Open_Instance, see tools.c). The loaders exit
+ *  on an error, so a new instance is first loaded by a child process
+ *  (Check_Instance): an invalid one gets an error record and the server
+ *  keeps the current instance. This check (a fork and a second load) is
+ *  the main cost of a new instance for a small problem, a request on the
+ *  current instance or a delta does not pay it.
+ *
+ *  With problem=NAME (adsolve only, see adsolve.c) the instance is one
+ *  of the problem NAME, which becomes the current problem. .SUFFIX is
+ *  the format of the instance (default: the suffix of the command line
+ *  file).
+ *
+ *  With delta, the NBYTES bytes are a change of the current instance
+ *  (see Apply_Delta of the problem) and the search continues from the
+ *  previous solution (warm start): the cost of the re-optimization
+ *  depends on the size of the change, not of the instance.
+ *
+ *  The answer to each request is a record (--format, jsonl by default)
+ *  with the solution (field sol), or an error record. The work arrays
+ *  (sol, Ad_Solve) are kept from a request to another. The field param
+ *  is the command-line file or "request N.SUFFIX" for an instance sent
+ *  by the request N of the stream (followed by " + K delta(s)").
+ *
+ *  With --serve=PATH requests are read from the connections to the Unix
+ *  socket PATH, each connection is a stream of requests and -j NB
+ *  processes accept connections (the engine is not thread-safe, each
+ *  worker is a process). A connection starts with the instance of the
+ *  command line (the instances and deltas of a previous connection are
+ *  forgotten). Else requests are read on stdin and answered on stdout.
+ */
+
+static void
+Catch_Alarm(int sig)
+{
+  ad_stop = 1;
+}
+
+
+static void
+Set_Timer(int ms)
+{
+  struct itimerval t;
+
+  memset(&t, 0, sizeof(t));
+  t.it_value.tv_sec = ms / 1000;
+  t.it_value.tv_usec = (ms % 1000) * 1000;
+  setitimer(ITIMER_REAL, &t, NULL);
+}
+
+
+static void
+Serve_Error(FILE *out, char *msg)
+{
+  if (out_format == FORMAT_JSONL)
+    fprintf(out, "{\"error\":\"%s\"}\n", msg);
+  else
+    fprintf(out, "error,%s\n", msg);
+  fflush(out);
+}
+
+
+static int
+Serve_Skip(FILE *in, int nbytes)	/* skips an instance, returns 0 if truncated */
+{
+  char tmp[4096];
+  int n;
+
+  for(; nbytes > 0; nbytes -= n)
+    {
+      n = (nbytes < (int) sizeof(tmp)) ? nbytes : (int) sizeof(tmp);
+      if ((int) fread(tmp, 1, n, in) != n)
+	return 0;
+    }
+
+  return 1;
+}
+
+
+
+
+/*
+ *  CHECK_INSTANCE
+ *
+ *  The loaders of the problems exit on an error: a child process loads
+ *  the instance file_name (Init_Instance, then Solve stopped at once) to
+ *  check it. Returns 1 if the instance is valid.
+ */
+static int
+Check_Instance(AdData *p_ad, AdData *p_opt, char *file_name, FILE *in)
+{
+  RunStat run_stat;
+  pid_t pid;
+  int status;
+
+  fflush(NULL);
+  if ((pid = fork()) < 0)
+    {
+      perror("fork");
+      return 0;
+    }
+
+  if (pid == 0)
+    {
+      close(fileno(in));	/* exit() must not move the input of the parent */
+      No_Gcc_Warn_Unused_Result(freopen("/dev/null", "w", stdout));
+      Free_Problem(p_ad);
+      *p_ad = *p_opt;
+      strcpy(p_ad->param_file, file_name);
+      Init_Instance(p_ad);
+      ad_stop = 1;
+      Do_Run(p_ad, 1, &run_stat);
+      _exit(0);
+    }
+
+  return waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+
+
+
+/*
+ *  SERVE_STREAM
+ *
+ *  Answers the requests read on in until end of file. p_opt is the
+ *  configuration of the command line (before Init_Parameters).
+ */
+static void
+Serve_Stream(AdData *p_ad, AdData *p_opt, FILE *in, FILE *out)
+{
+  static char *buff = NULL;	/* the request being read */
+  static int buff_size = 0;
+  static char *inst = NULL;	/* the current instance (if sent by a request) */
+  static int inst_size = 0;
+  static char inst_name[64];
+  int inst_len = 0;
+  RunStat run_stat, *r = &run_stat;
+  char line[1024], kind[512], suffix_req[17], name_req[64];
+  char *pb_name, *suffix, *name;
+  int seed, time_ms, nbytes, n, k, cost;
+  int is_delta, warm, nb_delta;
+  int have_inst = 1;		/* is there a current instance ? */
+  int have_sol = 0;		/* p_ad->sol is a solution of the current instance ? */
+  int changed = 0;		/* the current instance is not the one of the command line ? */
+  int nb_req = 0;
+  char *p;
+
+  f_rec = out;
+  rec_header_done = 0;
+  strcpy(serve_param, p_opt->param_file);
+
+  while(fgets(line, sizeof(line), in))
+    {
+      n = sscanf(line, "%d %d %d %511s %16s", &seed, &time_ms, &nbytes, kind, suffix_req);
+      is_delta = (n == 4 && strcmp(kind, "delta") == 0);
+      pb_name = (n >= 4 && strncmp(kind, "problem=", 8) == 0) ? kind + 8 : NULL;
+      if (n < 3 || (n >= 4 && !is_delta && pb_name == NULL) || time_ms < 0 || nbytes < 0)
+	{
+	  Serve_Error(out, "bad request header (SEED TIME_MS NBYTES [delta | problem=NAME [.SUFFIX]] expected)");
+	  break;		/* cannot resynchronize */
+	}
+
+      if (nbytes >= buff_size && nbytes <= SERVE_MAX_NBYTES)
+	{
+	  if ((p = realloc(buff, nbytes + 1)) != NULL)
+	    {
+	      buff = p;
+	      buff_size = nbytes + 1;
+	    }
+	}
+      if (nbytes >= buff_size)
+	{
+	  Serve_Error(out, (nbytes > SERVE_MAX_NBYTES) ? "instance too large" : "out of memory");
+	  if (!Serve_Skip(in, nbytes))
+	    break;
+	  continue;
+	}
+      if ((int) fread(buff, 1, nbytes, in) != nbytes)
+	{
+	  Serve_Error(out, "truncated instance");
+	  break;
+	}
+      buff[nbytes] = '\0';
+
+      if (pb_name && (ad_no_select_pb_fct || nbytes == 0))
+	{
+	  Serve_Error(out, (ad_no_select_pb_fct) ? "only adsolve can change the problem" :
+		      "a change of problem needs an instance");
+	  continue;
+	}
+
+      warm = 0;
+      if (is_delta)
+	{
+	  if (ad_no_apply_delta_fct)
+	    {
+	      Serve_Error(out, "this problem cannot apply a delta");
+	      continue;
+	    }
+	  if (!have_sol)
+	    {
+	      Serve_Error(out, "a delta needs a previous solve of the instance");
+	      continue;
+	    }
+	  changed = 1;
+	  if ((cost = Apply_Delta(p_ad, buff)) < -1)
+	    {
+	      have_sol = 0;	/* the data of the problem can be inconsistent */
+	      Serve_Error(out, "invalid delta");
+	      continue;
+	    }
+	  p_ad->total_cost = cost;
+	  if ((p = strstr(serve_param, " + ")) == NULL)
+	    p = serve_param + strlen(serve_param);
+	  nb_delta = (*p) ? atoi(p + 3) : 0;
+	  sprintf(p, " + %d delta(s)", nb_delta + 1);
+	  warm = 1;
+	}
+      else if (nbytes > 0)
+	{
+	  if (pb_name)
+	    {
+	      Free_Problem(p_ad); /* the instance of the current problem */
+	      have_inst = have_sol = 0;
+	      changed = 1;
+	      if ((name = Select_Problem(pb_name)) == NULL)
+		{
+		  Select_Problem(prog_name);
+		  Serve_Error(out, "unknown problem");
+		  continue;
+		}
+	      prog_name = name;
+	    }
+
+	  if (ad_no_free_pb_fct)
+	    {
+	      Serve_Error(out, "this problem can only solve the instance of the command line");
+	      continue;
+	    }
+
+				/* the name of the instance in memory (also in the records) with the */
+				/* suffix of the request or of the command line file (e.g. .dat or .smp) */
+	  suffix = (n == 5) ? suffix_req : strrchr(p_opt->param_file, '.');
+	  if (suffix == NULL || *suffix != '.' || strchr(suffix, '/') || strlen(suffix) > 16)
+	    suffix = "";
+	  sprintf(name_req, "request %d%s", nb_req + 1, suffix);
+
+	  Set_Memory_Instance(name_req, buff, nbytes);
+	  if (!Check_Instance(p_ad, p_opt, name_req, in))
+	    {
+	      Set_Memory_Instance((inst_len > 0) ? inst_name : NULL, inst, inst_len);
+	      Serve_Error(out, "invalid instance");
+	      continue;
+	    }
+
+	  p = inst;		/* the request becomes the current instance */
+	  inst = buff;
+	  buff = p;
+	  k = inst_size;
+	  inst_size = buff_size;
+	  buff_size = k;
+	  inst_len = nbytes;
+	  strcpy(inst_name, name_req);
+	  Set_Memory_Instance(inst_name, inst, inst_len);
+
+	  Free_Problem(p_ad);
+	  *p_ad = *p_opt;
+	  strcpy(p_ad->param_file, inst_name);
+	  Init_Instance(p_ad);
+	  strcpy(serve_param, inst_name);
+	  have_inst = 1;
+	  have_sol = 0;
+	  changed = 1;
+	}
+      else if (!have_inst)
+	{
+	  Serve_Error(out, "no current instance");
+	  continue;
+	}
+
+      if (seed < 0)
+	seed = Run_Seed();
+
+      p_ad->do_not_init = p_ad->warm_start = warm;
+      ad_stop = 0;
+      if (time_ms > 0)
+	Set_Timer(time_ms);
+      Do_Run(p_ad, seed, r);
+      Set_Timer(0);
+      ad_stop = 0;
+      p_ad->do_not_init = p_ad->warm_start = 0;
+      have_sol = 1;
+
+      Emit_Record(p_ad, ++nb_req, r);
+      fflush(out);
+    }
+
+  if (changed && !ad_no_free_pb_fct) /* back to the instance of the command line */
+    {
+      Free_Problem(p_ad);
+      if (prog_name != serve_pb_name)
+	prog_name = Select_Problem(serve_pb_name);
+      *p_ad = *p_opt;
+      Init_Instance(p_ad);
+    }
+  Set_Memory_Instance(NULL, NULL, 0);
+}
+
+
+
+
+/*
+ *  SERVE
+ *
+ *  Runs the server (does not return).
+ */
+static void
+Serve(AdData *p_ad)
+{
+  struct sockaddr_un addr;
+  int sock, conn, w;
+  pid_t pid;
+  FILE *in, *out;
+
+  signal(SIGALRM, Catch_Alarm);
+  signal(SIGPIPE, SIG_IGN);
+  serve_pb_name = prog_name;
+
+  if (*serve_path == '\0')
+    {
+      Serve_Stream(p_ad, &serve_opt, stdin, f_rec);
+      exit(0);
+    }
+
+  if ((sock = socket(AF_UNIX, SOCK_STREAM, 0)) < 0)
+    {
+      perror("socket");
+      exit(1);
+    }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, serve_path, sizeof(addr.sun_path) - 1);
+  unlink(serve_path);
+  if (bind(sock, (struct sockaddr *) &addr, sizeof(addr)) < 0 || listen(sock, 64) < 0)
+    {
+      perror(serve_path);
+      exit(1);
+    }
+
+  printf("serving on %s with %d process(es)\n", serve_path, nb_workers);
+
+  for(w = 1; w < nb_workers; w++) /* the master is worker 0 */
+    {
+      if ((pid = fork()) < 0)
+	{
+	  perror("fork");
+	  exit(1);
+	}
+      if (pid == 0)
+	{
+#ifdef __linux__
+	  prctl(PR_SET_PDEATHSIG, SIGTERM);
+#endif
+	  break;
+	}
+    }
+  if (w >= nb_workers)
+    w = 0;
+
+  if (pin_workers)
+    Pin_To_Cpu(w);
+
+  for(;;)
+    {
+      if ((conn = accept(sock, NULL, NULL)) < 0)
+	continue;
+
+      if ((in = fdopen(conn, "r")) == NULL || (out = fdopen(dup(conn), "w")) == NULL)
+	{
+	  perror("fdopen");
+	  exit(1);
+	}
+      Serve_Stream(p_ad, &serve_opt, in, out);
+      fclose(out);
+      fclose(in);
+    }
+}
+
+#endif /* !CELL */
+
+
+
+
+/*
+ *  DISPLAY_DISTRIBUTION
+ *
+ *  Displays the distribution of the run-times (CPU time of each run) and
+ *  nb of iterations of the solved runs, fits it and predicts the speedup
+ *  of k independent walks (the first walk which solves stops the others).
+ *  Writes the time-to-target data if asked (--ttt).
+ */
+static void
+Display_Distribution(double *run_time, double *run_iter, int n)
+{
+  StatSummary st, si;
+  StatExpFit et, ei;
+  StatLogNormFit lt, li;
+  double e1t, e1i;
+  int k;
+
+  if (n < 2)
+    return;
+
+  Stat_Sort(run_time, n);
+  Stat_Sort(run_iter, n);
+
+  Stat_Summary(run_time, n, &st);
+  Stat_Summary(run_iter, n, &si);
+  Stat_Fit_Shifted_Exp(run_time, n, &et);
+  Stat_Fit_Shifted_Exp(run_iter, n, &ei);
+  Stat_Fit_Lognormal(run_time, n, &lt);
+  Stat_Fit_Lognormal(run_iter, n, &li);
+
+  printf("\ndistribution of %d solved runs:\n", n);
+  printf("|        |%14s |         iters |\n", (nb_walks > 0) ? "time (wall s)" : "time (cpu s)");
+  printf("|--------|---------------|---------------|\n");
+#define Line(name, field)  printf("| %-6s | %13.6f | %13.1f |\n", name, st.field, si.field)
+  Line("mean", mean);
+  Line("stddev", stddev);
+  Line("min", min);
+  Line("q10", q10);
+  Line("q25", q25);
+  Line("median", median);
+  Line("q75", q75);
+  Line("q90", q90);
+  Line("max", max);
+#undef Line
+
+  printf("\nfits (KS = Kolmogorov-Smirnov distance, the smaller the better):\n");
+  printf("  time : shifted exp x0: %g 1/lambda: %g (KS: %.3f) - lognormal mu: %g sigma: %g (KS: %.3f)\n",
+	 et.x0, 1 / et.lambda, et.ks, lt.mu, lt.sigma, lt.ks);
+  printf("  iters: shifted exp x0: %g 1/lambda: %g (KS: %.3f) - lognormal mu: %g sigma: %g (KS: %.3f)\n",
+	 ei.x0, 1 / ei.lambda, ei.ks, li.mu, li.sigma, li.ks);
+
+  if (nb_walks > 0)
+    printf("\npredicted speedup of k independent runs of %d walks (empirical / shifted exp):\n", nb_walks);
+  else
+    printf("\npredicted speedup of k independent walks (empirical / shifted exp):\n");
+  printf("|     k |       time speedup |      iters speedup |\n");
+  printf("|-------|--------------------|--------------------|\n");
+  e1t = Stat_Expected_Min(run_time, n, 1);
+  e1i = Stat_Expected_Min(run_iter, n, 1);
+  for(k = 2; k <= MAX_WALKS; k *= 2)
+    printf("| %5d | %8.2f / %7.2f | %8.2f / %7.2f |\n", k,
+	   e1t / Stat_Expected_Min(run_time, n, k), e1t / Stat_Shifted_Exp_Expected_Min(&et, k),
+	   e1i / Stat_Expected_Min(run_iter, n, k), e1i / Stat_Shifted_Exp_Expected_Min(&ei, k));
+  if (n < MAX_WALKS)
+    printf("(empirical predictions for k close to or above %d runs are not reliable)\n", n);
+
+  if (ttt_file)
+    {
+      if (Stat_Write_TTT(ttt_file, run_time, run_iter, n, &et))
+	printf("\ntime-to-target data written in %s\n", ttt_file);
+      else
+	perror(ttt_file);
+    }
+}
+
+
+
+
+/*
+ *  ADD_PERF
+ *
+ *  Adds the counters per phase of a run to the totals.
+ */
+static void
+Add_Perf(RunStat *r)
+{
+  int ph, k;
+
+  if (!ad_has_perf)
+    return;
+
+  for(ph = 0; ph < AD_NB_PHASES; ph++)
+    {
+      perf_tot[ph].nb_calls += r->perf[ph].nb_calls;
+      for(k = 0; k < AD_NB_COUNTERS; k++)
+	perf_tot[ph].val[k] += r->perf[ph].val[k];
+    }
+
+  for(k = 0; k < AD_NB_COUNTERS; k++)
+    perf_avail[k] |= r->perf_avail[k];
+}
+
+
+
+
+/*
+ *  DISPLAY_PERF
+ *
+ *  Displays the counters per phase of the engine (ad_solver.c compiled
+ *  with PERF_COUNTERS). IPC (instructions per cycle) and the cache misses
+ *  per 1000 instructions tell if a phase is compute or memory bound.
+ */
+static void
+Display_Perf(void)
+{
+  AdPerfPhase *p;
+  double ns_tot = 0;
+  int ph;
+
+  if (!ad_has_perf)
+    return;
+
+  for(ph = 0; ph < AD_NB_PHASES; ph++)
+    ns_tot += perf_tot[ph].val[AD_CNT_NS];
+
+  printf("\ncounters per phase of the engine:\n");
+  printf("| phase       |      calls | time %% |  ns/call |       cycles |       instrs |  IPC |"
+	 " cache miss | miss/kinstr | branch miss |\n");
+  printf("|-------------|------------|--------|----------|--------------|--------------|------|"
+	 "------------|-------------|-------------|\n");
+
+  for(ph = 0; ph < AD_NB_PHASES; ph++)
+    {
+      p = &perf_tot[ph];
+      printf("| %-11s | %10lld | %6.2f | %8.0f |", perf_phase_name[ph], p->nb_calls,
+	     (ns_tot > 0) ? 100 * p->val[AD_CNT_NS] / ns_tot : 0.0,
+	     (p->nb_calls) ? (double) p->val[AD_CNT_NS] / p->nb_calls : 0.0);
+
+      if (perf_avail[AD_CNT_CYCLES])
+	printf(" %12lld |", p->val[AD_CNT_CYCLES]);
+      else
+	printf(" %12s |", "n/a");
+
+      if (perf_avail[AD_CNT_INSTR])
+	printf(" %12lld |", p->val[AD_CNT_INSTR]);
+      else
+	printf(" %12s |", "n/a");
+
+      if (perf_avail[AD_CNT_CYCLES] && perf_avail[AD_CNT_INSTR] && p->val[AD_CNT_CYCLES])
+	printf(" %4.2f |", (double) p->val[AD_CNT_INSTR] / p->val[AD_CNT_CYCLES]);
+      else
+	printf(" %4s |", "n/a");
+
+      if (perf_avail[AD_CNT_CACHE_MISS])
+	printf(" %10lld |", p->val[AD_CNT_CACHE_MISS]);
+      else
+	printf(" %10s |", "n/a");
+
+      if (perf_avail[AD_CNT_CACHE_MISS] && perf_avail[AD_CNT_INSTR] && p->val[AD_CNT_INSTR])
+	printf(" %11.3f |", 1000.0 * p->val[AD_CNT_CACHE_MISS] / p->val[AD_CNT_INSTR]);
+      else
+	printf(" %11s |", "n/a");
+
+      if (perf_avail[AD_CNT_BRANCH_MISS])
+	printf(" %11lld |", p->val[AD_CNT_BRANCH_MISS]);
+      else
+	printf(" %11s |", "n/a");
+
+      printf("\n");
+    }
+}
+
+
+
+
+void
+Set_Initial(AdData *p_ad)
+{
+  int i;
+  switch (read_initial)
+    {
+    case 0:
+      break;
+
+    case 1:
+      printf("enter the initial configuration:\n");
+      for(i = 0; i < p_ad->size; i++)
+	if (scanf("%d", &p_ad->sol[i])) /* avoid gcc warning warn_unused_result */
+	  {}
+      getchar();		/* the last \n */
+      Display_Solution(p_ad);
+      p_ad->do_not_init = 1;
+      Check_Init_Configuration(p_ad);
+      break;
+
+    case 2:
+      p_ad->do_not_init = 1;
+      Set_Init_Configuration(p_ad);
+      break;
+    }
+
+#if defined(DEBUG) && (DEBUG & 1)
+  if (p_ad->do_not_init)
+    {
+      printf("++++++++++ values to pass to threads (do_not_init=1)\n");
+      Display_Solution(p_ad);
+      printf("+++++++++++++++++++++++++++\n");
+    }
+#endif
+}
+
+
+
+
+void
+Verify_Sol(AdData *p_ad)
+{
+  if (!check_valid)
+    return;
+
+  int c = Cost_Of_Solution(0);
+  if (c != p_ad->total_cost)
+    printf("\n*** ERROR real cost:%d != returned cost: %d\n", c, p_ad->total_cost);
+
+  if (p_ad->total_cost == 0 && !Check_Solution(p_ad))
+    printf("*** Erroneous Solution !!!\n");
+}
+
+
+
+
+/*
+ *  EMIT_RECORD
+ *
+ *  Emits a machine-readable record (JSONL or CSV) for a run on f_rec.
+ *  All records have the same fields in the same order (the CSV header
+ *  is emitted with the first record).
+ */
+
+static void
+Put_Str(const char *s)
+{
+  if (out_format == FORMAT_JSONL)
+    {
+      putc('"', f_rec);
+      for(; *s; s++)
+	if (*s == '"' || *s == '\\')
+	  fprintf(f_rec, "\\%c", *s);
+	else if ((unsigned char) *s < ' ')
+	  fprintf(f_rec, "\\u%04x", *s);
+	else
+	  putc(*s, f_rec);
+      putc('"', f_rec);
+    }
+  else				/* CSV: quote only if needed */
+    {
+      if (strpbrk(s, ",\"\n\r") == NULL)
+	{
+	  fputs(s, f_rec);
+	  return;
+	}
+      putc('"', f_rec);
+      for(; *s; s++)
+	{
+	  if (*s == '"')
+	    putc('"', f_rec);
+	  putc(*s, f_rec);
+	}
+      putc('"', f_rec);
+    }
+}
+
+
+static void
+Put_Vec(const int *v, int n)	/* JSON array or space separated values (CSV) */
+{
+  int i;
+
+  putc((out_format == FORMAT_JSONL) ? '[' : '"', f_rec);
+  for(i = 0; i < n; i++)
+    fprintf(f_rec, "%s%d", (i == 0) ? "" : (out_format == FORMAT_JSONL) ? "," : " ", v[i]);
+  putc((out_format == FORMAT_JSONL) ? ']' : '"', f_rec);
+}
+
+
+static void
+Emit_Record(AdData *p_ad, int run, RunStat *r)
+{
+  static char host[256];
+  static struct utsname uts;
+  static char param[32];
+  RecField rec[MAX_REC_FIELDS];
+  int nb = 0, k;
+
+#define Rec_Int(n, v)  (rec[nb].name = (n), rec[nb].type = 'i', rec[nb++].val = (v))
+#define Rec_Dbl(n, v)  (rec[nb].name = (n), rec[nb].type = 'd', rec[nb++].dval = (v))
+#define Rec_Str(n, s)  (rec[nb].name = (n), rec[nb].type = 's', rec[nb++].str = (s))
+#define Rec_Vec(n, v, sz) (rec[nb].name = (n), rec[nb].type = 'v', rec[nb].vec = (v), rec[nb++].val = (sz))
+
+  if (*host == '\0')
+    {
+      if (gethostname(host, sizeof(host) - 1) != 0)
+	strcpy(host, "unknown");
+      uname(&uts);
+      if (param_needed > 0)
+	sprintf(param, "%d", p_ad->param);
+    }
+
+  Rec_Str("problem", prog_name);
+  Rec_Str("param", (param_needed >= 0) ? param : (serve_path) ? serve_param : p_ad->param_file);
+  Rec_Int("run", run);
+  Rec_Int("seed", seed0);
+  Rec_Int("run_seed", r->seed);
+  Rec_Int("size", p_ad->size);
+  Rec_Int("solved", r->reached);
+  Rec_Int("total_cost", r->total_cost);
+  Rec_Int("wall_ns", r->wall_ns);
+  Rec_Int("cpu_ns", r->cpu_ns);
+  Rec_Dbl("iters_per_s", Per_Sec(r->nb_iter_tot, r->cpu_ns));
+  Rec_Dbl("swaps_per_s", Per_Sec(r->nb_swap_tot, r->cpu_ns));
+
+  Rec_Int("nb_restart", r->nb_restart);
+  Rec_Int("nb_iter", r->nb_iter);
+  Rec_Int("nb_swap", r->nb_swap);
+  Rec_Int("nb_reset", r->nb_reset);
+  Rec_Int("nb_local_min", r->nb_local_min);
+  Rec_Int("nb_same_var", r->nb_same_var);
+  Rec_Int("nb_iter_tot", r->nb_iter_tot);
+  Rec_Int("nb_swap_tot", r->nb_swap_tot);
+  Rec_Int("nb_reset_tot", r->nb_reset_tot);
+  Rec_Int("nb_local_min_tot", r->nb_local_min_tot);
+  Rec_Int("nb_same_var_tot", r->nb_same_var_tot);
+  Rec_Str("user_stat_name", (user_stat_name) ? user_stat_name : "");
+  Rec_Int("user_stat", r->user_stat);
+  Rec_Int("walks", nb_walks);
+  Rec_Int("walk", r->walk);
+  Rec_Str("walk_config", (walk_config && r->walk >= 0) ? walk_opt[r->walk] : "");
+
+  Rec_Int("prob_select_loc_min", p_ad->prob_select_loc_min);
+  Rec_Int("freeze_loc_min", p_ad->freeze_loc_min);
+  Rec_Int("freeze_swap", p_ad->freeze_swap);
+  Rec_Int("reset_limit", p_ad->reset_limit);
+  Rec_Int("reset_percent", p_ad->reset_percent);
+  Rec_Int("nb_var_to_reset", p_ad->nb_var_to_reset);
+  Rec_Int("restart_limit", p_ad->restart_limit);
+  Rec_Int("restart_max", p_ad->restart_max);
+  Rec_Int("exhaustive", p_ad->exhaustive);
+  Rec_Int("first_best", p_ad->first_best);
+  Rec_Int("conflict_set", p_ad->conflict_set);
+  Rec_Int("move_tries", p_ad->move_tries);
+  Rec_Int("adaptive", p_ad->adaptive);
+  Rec_Str("restart_policy", restart_policy_name[p_ad->restart_policy]);
+  Rec_Int("restart_grow", p_ad->restart_grow);
+  Rec_Int("restart_from_best", p_ad->restart_from_best);
+  Rec_Int("optim_pb", p_ad->optim_pb);
+  Rec_Int("target_cost", p_ad->target_cost);
+
+  Rec_Str("host", host);
+  Rec_Str("os", uts.sysname);
+  Rec_Str("os_release", uts.release);
+  Rec_Str("machine", uts.machine);
+  Rec_Int("nb_cpus", sysconf(_SC_NPROCESSORS_ONLN));
+  Rec_Str("compiler", __VERSION__);
+  Rec_Int("timestamp", time(NULL));
+  if (serve_path)
+    Rec_Vec("sol", p_ad->sol, p_ad->size);
+
+#undef Rec_Int
+#undef Rec_Dbl
+#undef Rec_Str
+#undef Rec_Vec
+
+  if (out_format == FORMAT_CSV && !rec_header_done)
+    {
+      for(k = 0; k < nb; k++)
+	fprintf(f_rec, "%s%s", (k) ? "," : "", rec[k].name);
+      putc('\n', f_rec);
+      rec_header_done = 1;
+    }
+
+  if (out_format == FORMAT_JSONL)
+    putc('{', f_rec);
+
+  for(k = 0; k < nb; k++)
+    {
+      if (k)
+	putc(',', f_rec);
+      if (out_format == FORMAT_JSONL)
+	fprintf(f_rec, "\"%s\":", rec[k].name);
+      if (rec[k].type == 's')
+	Put_Str(rec[k].str);
+      else if (rec[k].type == 'd')
+	fprintf(f_rec, "%.1f", rec[k].dval);
+      else if (rec[k].type == 'v')
+	Put_Vec(rec[k].vec, rec[k].val);
+      else
+	fprintf(f_rec, "%lld", rec[k].val);
+    }
+
+  if (out_format == FORMAT_JSONL)
+    putc('}', f_rec);
+  putc('\n', f_rec);
+}
+
+
+
+
+/*
+ *  LOAD_PROFILE
+ *
+ *  If --profile=FILE is given, the options of FILE (e.g. written by
+ *  adtune) are inserted before the other arguments (the options given
+ *  on the command line override them). A profile contains command-line
+ *  options separated by spaces or newlines, # starts a comment.
+ */
+static void
+Load_Profile(int *p_argc, char ***p_argv)
+{
+  int argc = *p_argc;
+  char **argv = *p_argv;
+  char **new_argv;
+  char buff[1024], *p;
+  FILE *f = NULL;
+  int i, k, n, nb_tok = 0, size_tok = 64;
+
+  for(i = 1; i < argc; i++)
+    if (strncmp(argv[i], "--profile=", 10) == 0)
+      break;
+
+  if (i >= argc)
+    return;
+
+  if ((f = fopen(argv[i] + 10, "rt")) == NULL)
+    {
+      perror(argv[i] + 10);
+      exit(1);
+    }
+
+  new_argv = malloc((size_tok + argc) * sizeof(char *));
+  if (new_argv == NULL)
+    {
+      fprintf(stderr, "%s:%d malloc failed\n", __FILE__, __LINE__);
+      exit(1);
+    }
+  new_argv[nb_tok++] = argv[0];
+
+  while(fgets(buff, sizeof(buff), f))
+    {
+      if ((p = strchr(buff, '#')) != NULL)
+	*p = '\0';
+
+      for(p = strtok(buff, " \t\r\n"); p; p = strtok(NULL, " \t\r\n"))
+	{
+	  if (nb_tok >= size_tok)
+	    {
+	      size_tok *= 2;
+	      new_argv = realloc(new_argv, (size_tok + argc) * sizeof(char *));
+	      if (new_argv == NULL)
+		{
+		  fprintf(stderr, "%s:%d malloc failed\n", __FILE__, __LINE__);
+		  exit(1);
+		}
+	    }
+	  new_argv[nb_tok++] = strdup(p);
+	}
+    }
+  fclose(f);
+
+  n = nb_tok;
+  for(k = 1; k < argc; k++)
+    if (k != i)
+      new_argv[n++] = argv[k];
+  new_argv[n] = NULL;
+
+  *p_argc = n;
+  *p_argv = new_argv;
+}
+
+
+
+
+#define L(msg) fprintf(stderr, msg "\n")
+
+
+/*
+ *  PARSE_CMD_LINE
+ *
+ */
+static void
+Parse_Cmd_Line(int argc, char *argv[], AdData *p_ad)
+{
+  int param_read = 0;
+  int i;
+
+  nb_threads = 1;
+  nb_workers = 1;
+  pin_workers = 0;
+
+  count = -1;
+  disp_mode = 1;
+  check_valid = 0;
+  read_initial = 0;
+
+  out_format = FORMAT_TABLE;
+  ttt_file = NULL;
+  prog_name = strrchr(argv[0], '/');
+  prog_name = (prog_name) ? prog_name + 1 : argv[0];
+
+  p_ad->param = -1;
+  p_ad->seed = -1;
+  p_ad->debug = 0;
+  p_ad->log_file = NULL;
+  p_ad->prob_select_loc_min = -1;
+  p_ad->freeze_loc_min = -1;
+  p_ad->freeze_swap = -1;
+  p_ad->reset_limit = -1;
+  p_ad->reset_percent = -1;
+  p_ad->restart_limit = -1;
+  p_ad->restart_max = -1;
+  p_ad->exhaustive = 0;
+  p_ad->first_best = 0;
+  p_ad->conflict_set = 0;
+  p_ad->move_tries = -1;
+  p_ad->adaptive = 0;
+  p_ad->restart_policy = AD_RESTART_FIXED;
+  p_ad->restart_grow = 50;
+  p_ad->restart_from_best = 0;
+  p_ad->optim_pb = 0;
+  p_ad->target_cost = 0;
+
+
+  for(i = 1; i < argc; i++)
+    {
+      if (argv[i][0] == '-')
+	{
+	  switch(argv[i][1])
+	    {
+	    case 'i':
+	      read_initial = 1;
+	      continue;
+
+	    case 'D':
+	      if (++i >= argc)
+		{
+		  L("debug level expected");
+		  exit(1);
+		}
+	      p_ad->debug = atoi(argv[i]);
+	      continue;
+
+	    case 's':
+	      if (++i >= argc)
+		{
+		  L("random seed expected");
+		  exit(1);
+		}
+	      p_ad->seed = atoi(argv[i]);
+	      continue;
+
+	    case 'L':
+	      if (++i >= argc)
+		{
+		  L("log file name expected");
 		  exit(1);
 		}
 	      p_ad->log_file = argv[i];
@@ -680,6 +2035,19 @@ Parse_Cmd_Line(int argc, char *argv[], AdData *p_ad)
 	      p_ad->restart_max = atoi(argv[i]);
 	      continue;
 
+	    case 'm':
+	      if (++i >= argc)
+		{
+		  L("number of compound moves expected");
+		  exit(1);
+		}
+	      p_ad->move_tries = atoi(argv[i]);
+	      continue;
+
+	    case 'A':
+	      p_ad->adaptive = 1;
+	      continue;
+
 	    case 'O':
 	      p_ad->optim_pb = 1;
 	      continue;
@@ -695,6 +2063,20 @@ Parse_Cmd_Line(int argc, char *argv[], AdData *p_ad)
 	      p_ad->target_cost = abs(p_ad->target_cost);
 	      continue;
 
+#ifndef CELL
+	    case 'j':
+	      if (++i >= argc)
+		{
+		  L("number of processes expected");
+		  exit(1);
+		}
+	      nb_workers = atoi(argv[i]);
+	      if (nb_workers <= 0)
+		nb_workers = sysconf(_SC_NPROCESSORS_ONLN);
+	      pin_workers = (argv[i - 1][2] != 'u'); /* -ju: unpinned */
+	      continue;
+#endif
+
 #ifdef CELL
 	    case 't':
 	      if (++i >= argc)
@@ -710,6 +2092,87 @@ Parse_Cmd_Line(int argc, char *argv[], AdData *p_ad)
 	      continue;
 #endif
 
+	    case '-':
+	      if (strncmp(argv[i], "--format=", 9) == 0)
+		{
+		  if (strcmp(argv[i] + 9, "jsonl") == 0)
+		    out_format = FORMAT_JSONL;
+		  else if (strcmp(argv[i] + 9, "csv") == 0)
+		    out_format = FORMAT_CSV;
+		  else if (strcmp(argv[i] + 9, "table") == 0)
+		    out_format = FORMAT_TABLE;
+		  else
+		    {
+		      L("format expected: table, jsonl or csv");
+		      exit(1);
+		    }
+		  continue;
+		}
+	      if (strncmp(argv[i], "--ttt=", 6) == 0)
+		{
+		  ttt_file = argv[i] + 6;
+		  continue;
+		}
+	      if (strncmp(argv[i], "--restart=", 10) == 0)
+		{
+		  char *s = argv[i] + 10;
+
+		  if (strcmp(s, "fixed") == 0)
+		    p_ad->restart_policy = AD_RESTART_FIXED;
+		  else if (strcmp(s, "luby") == 0)
+		    p_ad->restart_policy = AD_RESTART_LUBY;
+		  else if (strcmp(s, "progress") == 0)
+		    p_ad->restart_policy = AD_RESTART_PROGRESS;
+		  else if (strncmp(s, "geom", 4) == 0 && (s[4] == '\0' || s[4] == ':'))
+		    {
+		      p_ad->restart_policy = AD_RESTART_GEOMETRIC;
+		      if (s[4] == ':')
+			p_ad->restart_grow = atoi(s + 5);
+		    }
+		  else
+		    {
+		      L("restart policy expected: fixed, luby, geom[:PERCENT] or progress");
+		      exit(1);
+		    }
+		  continue;
+		}
+	      if (strcmp(argv[i], "--restart-best") == 0)
+		{
+		  p_ad->restart_from_best = 1;
+		  continue;
+		}
+#ifndef CELL
+	      if (strcmp(argv[i], "--serve") == 0 || strncmp(argv[i], "--serve=", 8) == 0)
+		{
+		  serve_path = (argv[i][7] == '=') ? argv[i] + 8 : "";
+		  continue;
+		}
+	      if (strncmp(argv[i], "--walks=", 8) == 0)
+		{
+		  nb_walks = atoi(argv[i] + 8);
+		  if (nb_walks <= 0)
+		    nb_walks = sysconf(_SC_NPROCESSORS_ONLN);
+		  continue;
+		}
+	      if (strncmp(argv[i], "--portfolio=", 12) == 0)
+		{
+		  portfolio = argv[i] + 12;
+		  continue;
+		}
+	      if (strncmp(argv[i], "--coord=", 8) == 0)
+		{
+		  coord_addr = argv[i] + 8;
+		  continue;
+		}
+	      if (strncmp(argv[i], "--worker=", 9) == 0)
+		{
+		  worker_addr = argv[i] + 9;
+		  continue;
+		}
+#endif
+	      fprintf(stderr, "unrecognized option %s (-h for a help)\n", argv[i]);
+	      exit(1);
+
 	    case 'h':
 	      fprintf(stderr, "Usage: %s [ OPTION ]", argv[0]);
 	      if (param_needed > 0)
@@ -724,6 +2187,8 @@ Parse_Cmd_Line(int argc, char *argv[], AdData *p_ad)
 	      L("   -c          check if the solution is valid");
 	      L("   -s SEED     specify random seed");
 	      L("   -b COUNT    bench COUNT times");
+	      L("   -j NB       do the -b runs with NB processes pinned to cpus (0 = nb of cpus)");
+	      L("   -ju NB      idem but processes are not pinned");
 	      L("   -d WHAT     set display info (needs -b), WHAT is:");
               L("                 0=only last iter counters, 1=sum of restart+last iter counters (default)");
 	      L("                 2=restart and last iter counters");
@@ -734,9 +2199,33 @@ Parse_Cmd_Line(int argc, char *argv[], AdData *p_ad)
 	      L("   -p PERCENT  reset PERCENT %% of variables");
 	      L("   -a NB       abort and restart when NB iterations are reached");
 	      L("   -r COUNT    restart at most COUNT times");
+	      L("   --restart=POLICY  how the -a limit evolves at each restart:");
+	      L("                 fixed (default), luby (-a NB * 1 1 2 1 1 2 4...),");
+	      L("                 geom[:PERCENT] (+PERCENT %% at each restart, default 50),");
+	      L("                 progress (restart after NB iterations without improvement)");
+	      L("   --restart-best  restart from a perturbation of the best configuration");
+	      L("   -m TRIES    try TRIES compound moves (3-cycle/double swap) when no swap improves");
+	      L("   -A          adapt freeze and reset parameters during the run (reactive search)");
 	      L("   -O          optimization problem (keep the best at each step)");
 	      L("   -T TARGET   stop when cost is <= TARGET (or when cost == -TARGET if TARGET is < 0)");
 	      L("   -e          exhaustive seach (do all combinations)");
+	      L("   --format=FMT  output format: table (default), jsonl or csv (one record per run");
+	      L("                 on stdout, the rest of the output goes to stderr)");
+	      L("   --ttt=FILE  write time-to-target data of the -b runs in FILE");
+	      L("   --profile=FILE  read options from FILE (e.g. written by adtune)");
+#ifndef CELL
+	      L("   --serve     server mode: solve the requests read on stdin (see main.c)");
+	      L("   --serve=PATH  idem on the Unix socket PATH (with -j NB processes)");
+	      L("   --walks=NB  multi-walk: each run is NB walks (processes), the first solution stops");
+	      L("                 the others (0 = nb of cpus)");
+	      L("   --coord=ADDR  idem with NB workers connecting to ADDR (a Unix socket path");
+	      L("                 or [HOST]:PORT)");
+	      L("   --worker=ADDR  be a worker (--walks=NB: NB workers) of the coordinator at ADDR");
+	      L("   --portfolio=FILE  multi-walk with one configuration (e.g. -P 80 -f 2..5) per line");
+	      L("                 of FILE for each walk (default --walks: one walk per line), a");
+	      L("                 value MIN..MAX is drawn at random for each run");
+	      L("   --portfolio=random  idem with random configurations (walk 0: the command line)");
+#endif
 	      L("   -h          show this help");
 #ifdef CELL
 	      L("");
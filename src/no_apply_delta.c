@@ -0,0 +1,32 @@
+/*
+ *  Adaptive search
+ *
+ *  Copyright (C) 2002-2011 Daniel Diaz, Philippe Codognet and Salvador Abreu
+ *
+ *  no_apply_delta.c: wrapper when user function Apply_Delta is not defined
+ */
+
+#include <stdio.h>
+
+#include "ad_solver.h"
+
+/*
+ *  APPLY_DELTA
+ *
+ */
+int
+Apply_Delta(AdData *p_ad, char *delta)
+{
+  fprintf(stderr, "%s:%d: error: wrapper Apply_Delta function called\n",
+	  __FILE__, __LINE__);
+  return -2;
+}
+
+static void
+Init(void) __attribute__ ((constructor));
+
+static void
+Init(void)
+{
+  ad_no_apply_delta_fct = 1;
+}
@@ -0,0 +1,28 @@
+/*
+ *  Adaptive search
+ *
+ *  Copyright (C) 2002-2011 Daniel Diaz, Philippe Codognet and Salvador Abreu
+ *
+ *  no_cost_all_var.c: wrapper when user function Cost_On_All_Variables is not defined
+ */
+
+#include <stdio.h>
+
+#include "ad_solver.h"
+
+void
+Cost_On_All_Variables(int *err)
+{
+  fprintf(stderr, "%s:%d: error: wrapper Cost_On_All_Variables function called\n",
+	  __FILE__, __LINE__);
+}
+
+
+static void
+Init(void) __attribute__ ((constructor));
+
+static void
+Init(void)
+{
+  ad_no_cost_all_var_fct = 1;
+}
@@ -0,0 +1,44 @@
+/*
+ *  Adaptive search
+ *
+ *  Copyright (C) 2002-2011 Daniel Diaz, Philippe Codognet and Salvador Abreu
+ *
+ *  no_cost_move.c: wrapper when user function Cost_If_Move is not defined
+ */
+
+#include <stdio.h>
+
+#include "ad_solver.h"
+
+/*
+ *  COST_IF_MOVE
+ *
+ *  A move is a sequence of swaps: (var[0],var[1]) then (var[2],var[3])...
+ */
+int
+Cost_If_Move(int current_cost, int *var, int nb_var)
+{
+  int k, x;
+  int r;
+
+  for(k = 0; k < nb_var; k += 2)
+    {
+      x = ad_sol[var[k]];
+      ad_sol[var[k]] = ad_sol[var[k + 1]];
+      ad_sol[var[k + 1]] = x;
+    }
+
+  r = Cost_Of_Solution(0);
+
+  for(k = nb_var - 2; k >= 0; k -= 2)
+    {
+      x = ad_sol[var[k]];
+      ad_sol[var[k]] = ad_sol[var[k + 1]];
+      ad_sol[var[k + 1]] = x;
+    }
+
+  if (ad_reinit_after_if_swap)
+    Cost_Of_Solution(0);
+
+  return r;
+}
@@ -0,0 +1,30 @@
+/*
+ *  Adaptive search
+ *
+ *  Copyright (C) 2002-2011 Daniel Diaz, Philippe Codognet and Salvador Abreu
+ *
+ *  no_free_pb.c: wrapper when user function Free_Problem is not defined
+ */
+
+#include <stdio.h>
+
+#include "ad_solver.h"
+
+/*
+ *  FREE_PROBLEM
+ *
+ *  Nothing to free: the problem cannot load another instance.
+ */
+void
+Free_Problem(AdData *p_ad)
+{
+}
+
+static void
+Init(void) __attribute__ ((constructor));
+
+static void
+Init(void)
+{
+  ad_no_free_pb_fct = 1;
+}
@@ -6,9 +6,20 @@
  *  no_next_i.c: wrapper when user function Next_I is not defined
  */
 
+#include "ad_solver.h"
+
 
 int 
 Next_I(int i)
 {
   return i + 1;
 }
+
+static void
+Init(void) __attribute__ ((constructor));
+
+static void
+Init(void)
+{
+  ad_no_next_i_fct = 1;
+}
@@ -6,6 +6,8 @@
  *  no_next_j.c: wrapper when user function Next_J is not defined
  */
 
+#include "ad_solver.h"
+
 
 /* if exhaustive generates for a i: i+1, i+2, ...
  * if not exhaustive: 0, 1, 2, ...
@@ -19,3 +21,12 @@ Next_J(int i, int j, int exhaustive)
 
   return j + 1;
 }
+
+static void
+Init(void) __attribute__ ((constructor));
+
+static void
+Init(void)
+{
+  ad_no_next_j_fct = 1;
+}
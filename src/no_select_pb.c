@@ -0,0 +1,33 @@
+/*
+ *  Adaptive search
+ *
+ *  Copyright (C) 2002-2011 Daniel Diaz, Philippe Codognet and Salvador Abreu
+ *
+ *  no_select_pb.c: wrapper when Select_Problem is not defined (a bench)
+ */
+
+#include <stdio.h>
+
+#include "ad_solver.h"
+
+/*
+ *  SELECT_PROBLEM
+ *
+ *  The problem is the bench itself (linked with the library).
+ */
+char *
+Select_Problem(char *name)
+{
+  fprintf(stderr, "%s:%d: error: wrapper Select_Problem function called\n",
+	  __FILE__, __LINE__);
+  return NULL;
+}
+
+static void
+Init(void) __attribute__ ((constructor));
+
+static void
+Init(void)
+{
+  ad_no_select_pb_fct = 1;
+}
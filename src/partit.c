@@ -125,7 +125,7 @@ Cost_Of_Solution(int should_be_recorded)
       cur_mid_x2 += x * x;
     }
 
-  r = coeff * abs(sum_mid_x - cur_mid_x) + abs(sum_mid_x2 - cur_mid_x2);
+  r = coeff * abs(sum_mid_x - cur_mid_x) + llabs(sum_mid_x2 - cur_mid_x2);
 
   return r;
 }
@@ -175,7 +175,7 @@ Cost_If_Swap(int current_cost, int i1, int i2)
 
   cm_x = cur_mid_x - xi1 + xi2;
   cm_x2 = cur_mid_x2 - xi12 + xi22;
-  r = coeff * abs(sum_mid_x - cm_x) + abs(sum_mid_x2 - cm_x2);
+  r = coeff * abs(sum_mid_x - cm_x) + llabs(sum_mid_x2 - cm_x2);
 
   return r;
 }
@@ -183,6 +183,56 @@ Cost_If_Swap(int current_cost, int i1, int i2)
 
 
 
+/*
+ *  COST_IF_MOVE
+ *
+ *  Evaluates the new total cost for a compound move: the swaps
+ *  (var[0],var[1]), (var[2],var[3])... Only the swaps between both
+ *  halves change the sums of the first half.
+ */
+
+int
+Cost_If_Move(int current_cost, int *var, int nb_var)
+{
+  int k, i1, i2, xi1, xi2, x;
+  int cm_x = cur_mid_x;
+  long long cm_x2 = cur_mid_x2;
+
+  for(k = 0; k < nb_var; k += 2)	/* swap in sol then undo (below) */
+    {
+      i1 = var[k];
+      i2 = var[k + 1];
+      xi1 = sol[i1];
+      xi2 = sol[i2];
+
+      if (i1 < size2 && i2 >= size2)
+	{
+	  cm_x += xi2 - xi1;
+	  cm_x2 += xi2 * xi2 - xi1 * xi1;
+	}
+      else if (i2 < size2 && i1 >= size2)
+	{
+	  cm_x += xi1 - xi2;
+	  cm_x2 += xi1 * xi1 - xi2 * xi2;
+	}
+
+      sol[i1] = xi2;
+      sol[i2] = xi1;
+    }
+
+  for(k = nb_var - 2; k >= 0; k -= 2)
+    {
+      x = sol[var[k]];
+      sol[var[k]] = sol[var[k + 1]];
+      sol[var[k + 1]] = x;
+    }
+
+  return coeff * abs(sum_mid_x - cm_x) + llabs(sum_mid_x2 - cm_x2);
+}
+
+
+
+
 /*
  *  EXECUTED_SWAP
  *
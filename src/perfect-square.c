@@ -28,6 +28,14 @@
  * keeping original pb number (-1 if not from the above site)
  */
 
+typedef struct
+{
+  int x;			/* first column of the segment */
+  int width;			/* nb of columns (all at the same height) */
+  int y;			/* height of the segment */
+} Segment;
+
+
 typedef struct
 {
   int orig_pb_number;		/* not used */
@@ -69,9 +77,12 @@ static int pb_no;
 static int master_square_size;
 static int nb_squares;
 
-static int col_y[600];		/* size should be >= at greatest master_square_size */
-static int col_x[600];
+static Segment *skyline;	/* skyline: runs of columns with same height (left to right) */
+static int nb_seg;		/* nb of segments in skyline[] */
+static int *col_x;		/* for each row: first free x on the right of the placed squares */
 static int y_max;
+static int master_square_size_alloc;
+static int nb_squares_alloc;
 
 
 #ifndef ACTUAL_VALUES
@@ -97,6 +108,37 @@ static int y_max;
 #define DETAIL
 #endif
 
+/*
+ *  ALLOC_SKYLINE
+ *
+ *  Allocates (or enlarges) the skyline and col_x[] for a given problem.
+ *  A placement splits at most one segment thus nb_squares + 1 segments
+ *  are enough.
+ */
+static void
+Alloc_Skyline(int master_square_size, int nb_squares)
+{
+  if (master_square_size > master_square_size_alloc)
+    {
+      col_x = (int *) realloc(col_x, master_square_size * sizeof(int));
+      master_square_size_alloc = master_square_size;
+    }
+
+  if (nb_squares > nb_squares_alloc)
+    {
+      skyline = (Segment *) realloc(skyline, (nb_squares + 1) * sizeof(Segment));
+      nb_squares_alloc = nb_squares;
+    }
+
+  if (col_x == NULL || skyline == NULL)
+    {
+      fprintf(stderr, "%s:%d malloc failed\n", __FILE__, __LINE__);
+      exit(1);
+    }
+}
+
+
+
 /*
  *  SOLVE
  *
@@ -117,20 +159,33 @@ Solve(AdData *p_ad)
   master_square_size = pb[pb_no].master_square_size;
   nb_squares = pb[pb_no].nb_squares;
 
+  Alloc_Skyline(master_square_size, nb_squares);
+
   Ad_Solve(p_ad);
 }
 
 
-/* return the no of square that cannot be placed (or size if all are placed) */
+/* return the no of square that cannot be placed (or size if all are placed)
+ *
+ * The bottom-left placement only works on the skyline: adjacent segments
+ * always have different heights (they are merged else). Thus the leftmost 
+ * lowest column is the start of a segment and the width check is simply 
+ * a comparison with the width of this segment.
+ */
 
 static __inline__
 int Place_Squares(int *sol, int size, int master_square_size, char **ascii_repres)
 {
-  int i, sz, c, x_pos, y_pos;
+  int i, k, sz, x_pos, y_pos;
+  Segment *s;
   
-  memset((void *) col_y, 0, master_square_size * sizeof(int));
   memset((void *) col_x, 0, master_square_size * sizeof(int));
 
+  skyline[0].x = 0;
+  skyline[0].width = master_square_size;
+  skyline[0].y = 0;
+  nb_seg = 1;
+
   y_max = 0;
 
   for(i = 0; i < size; i++)
@@ -138,26 +193,28 @@ int Place_Squares(int *sol, int size, int master_square_size, char **ascii_repre
       sz = SIZE(i);
 
       y_pos = master_square_size - sz + 1; /* max possible on the y-axis, look for the min */
-      x_pos = -1;
+      k = -1;
 
-      for(c = 0; c <= master_square_size - sz; c++) /* look for the smallest y */
+      for(s = skyline; s < skyline + nb_seg && s->x <= master_square_size - sz; s++) /* look for the smallest y */
         {
-          if (col_y[c] < y_pos)
+          if (s->y < y_pos)
             {
-	      x_pos = c;
-	      y_pos = col_y[c];
+	      k = s - skyline;
+	      y_pos = s->y;
 
 	      if (y_pos == 0)	/* optimization: exit now if 0 is found */
 		break;
 	    }
 	}
 
-      if (x_pos < 0)		/* the current square cannot be placed on the y-axis or the x-axis */
+      if (k < 0)		/* the current square cannot be placed on the y-axis or the x-axis */
+	return i;
+
+      s = skyline + k;
+      if (s->width < sz)	/* check if width is ok */
 	return i;
 
-      for(c = 1; c < sz; c++)	/* check if width is ok */
-	if (col_y[x_pos + c] != y_pos)
-	  return i;
+      x_pos = s->x;
 
 #ifdef DETAIL
       printf("square sz:%2d  placed at x_pos:%d  y_pos:%d\n", sz, x_pos, y_pos);
@@ -181,18 +238,40 @@ int Place_Squares(int *sol, int size, int master_square_size, char **ascii_repre
       if (y_pos > y_max)
 	y_max = y_pos;
 
-      while(sz--)
-	col_y[x_pos++] = y_pos;
+				/* update the skyline: raise [x_pos, x_pos+sz) to y_pos */
+      if (s->width > sz)	/* split: the right part remains at the old height */
+	{
+	  memmove(s + 1, s, (skyline + nb_seg - s) * sizeof(Segment));
+	  nb_seg++;
+	  s[1].x += sz;
+	  s[1].width -= sz;
+	  s->width = sz;
+	}
+      s->y = y_pos;
+
+      if (k + 1 < nb_seg && s[1].y == y_pos) /* merge with the right neighbor */
+	{
+	  s->width += s[1].width;
+	  memmove(s + 1, s + 2, (skyline + nb_seg - (s + 2)) * sizeof(Segment));
+	  nb_seg--;
+	}
+
+      if (k > 0 && s[-1].y == y_pos) /* merge with the left neighbor */
+	{
+	  s[-1].width += s->width;
+	  memmove(s, s + 1, (skyline + nb_seg - (s + 1)) * sizeof(Segment));
+	  nb_seg--;
+	}
       
 #ifdef DETAIL
-      printf("col_y: ");
-      for(c = 0; c < master_square_size; c++)
-	printf("%2d ", col_y[c]);
+      printf("skyline: ");
+      for(k = 0; k < nb_seg; k++)
+	printf("[%d..%d]:%d ", skyline[k].x, skyline[k].x + skyline[k].width - 1, skyline[k].y);
       printf("\ny_max:%d\n", y_max);
 #if 0
       printf("col_x: ");
-      for(c = 0; c < master_square_size; c++)
-	printf("%2d ", col_x[c]);
+      for(k = 0; k < master_square_size; k++)
+	printf("%2d ", col_x[k]);
       printf("\n");
 #endif
 #endif      
@@ -250,19 +329,17 @@ Cost_Of_Solution(int should_be_recorded)
     }
 
 
-  /* compute ry : sum of all y (unfilled y - consecutive same y are counted once)  */
+  /* compute ry : sum of all y (unfilled y - consecutive same y are counted once, i.e. one per segment)  */
 
-  for(c = 0; c < master_square_size; c++)
+  for(c = 0; c < nb_seg; c++)
     {
-      if (col_y[c] == master_square_size)
+      y = skyline[c].y;
+      if (y == master_square_size)
 	continue;
 
-      for(x = c, y = col_y[c]; x < master_square_size && col_y[x] == y; x++)
-	;
-
 #ifdef DETAIL
       printf("vert rectangle at %3d/%d  width=%2d  height wrt y_max=%d   top=%d\n", 
-	     c, y, x - c, y_max - y, master_square_size - y);
+	     skyline[c].x, y, skyline[c].width, y_max - y, master_square_size - y);
 #endif
       
       nb_empty_rect++;
@@ -272,7 +349,6 @@ Cost_Of_Solution(int should_be_recorded)
 	max_height = y;
 
       ry += y;
-      c = x - 1;
     }
 
   /* compute rx : sum of all x (unfilled x - consecutive same x are counted once, stop at y_max)  */
@@ -411,6 +487,8 @@ Check_Solution(AdData *p_ad)
   int pb_no = p_ad->param;
   int master_square_size = pb[pb_no].master_square_size;
  
+  Alloc_Skyline(master_square_size, p_ad->size);
+
   int i = Random_Permut_Check(p_ad->sol, p_ad->size, p_ad->actual_value, p_ad->base_value);
 
   if (i >= 0)
@@ -112,7 +112,7 @@ QAP_Load_Problem(char *file_name, QAPInfo *qi, int header_only)
   int n;
   FILE *f;
 
-  if ((f = fopen(file_name, "rt")) == NULL) {
+  if ((f = Open_Instance(file_name)) == NULL) {
     perror(file_name);
     exit(1);
   }
@@ -43,6 +43,9 @@ static QAPMatrix mat_A, mat_B;
 static QAPMatrix delta;
 #endif
 
+static int *touched;		/* Apply_Delta: vars whose delta[][] must be recomputed */
+static int *inv;		/* Apply_Delta: inverse of sol (var of a value) */
+
 /*------------*
  * Prototypes *
  *------------*/
@@ -93,6 +96,32 @@ Solve(AdData *p_ad)
 
 
 
+/*
+ *  FREE_PROBLEM
+ *
+ *  Forgets the current instance (the next Solve reads p_ad->param_file).
+ */
+
+void
+Free_Problem(AdData *p_ad)
+{
+  if (mat_A == NULL)
+    return;
+
+  QAP_Free_Matrix(qap_info.a, qap_info.size);
+  QAP_Free_Matrix(qap_info.b, qap_info.size);
+#if SPEED == 2
+  QAP_Free_Matrix(delta, qap_info.size);
+#endif
+  mat_A = mat_B = NULL;
+  free(touched);
+  free(inv);
+  touched = inv = NULL;
+}
+
+
+
+
 
 /*  The following functions are strongly inspired from of E. Taillard's
  *  Robust Taboo Search code.
@@ -255,6 +284,113 @@ Executed_Swap(int i1, int i2)
 
 
 
+/*
+ *  APPLY_DELTA
+ *
+ *  Modifies the loaded instance, keeping the current solution. The delta
+ *  is a text with one change per line (indices start at 1):
+ *
+ *    a I J V       a[I][J] = V (first matrix of the file)
+ *    b I J V       b[I][J] = V (second matrix of the file)
+ *
+ *  The cost is updated in O(1) per change. delta[i][j] only depends on
+ *  the rows and columns i and j of mat_A (and sol[i], sol[j] of mat_B):
+ *  only the pairs with a touched var are recomputed, i.e. O(t * size^2)
+ *  for t touched vars instead of O(size^3).
+ *
+ *  Returns the new cost (-2 if the delta is invalid, the instance can
+ *  then be partially modified).
+ */
+
+int
+Apply_Delta(AdData *p_ad, char *delta_txt)
+{
+  int cost = p_ad->total_cost;
+  int nb_touched = 0;
+  char m, *p, *q;
+  int i, j, k, x, n;
+  QAPMatrix mat;
+
+  if (touched == NULL)
+    {
+      touched = (int *) malloc(size * sizeof(int));
+      inv = (int *) malloc(size * sizeof(int));
+    }
+  if (touched == NULL || inv == NULL)
+    {
+      fprintf(stderr, "%s:%d malloc failed\n", __FILE__, __LINE__);
+      exit(1);
+    }
+  memset(touched, 0, size * sizeof(int));
+
+  for(i = 0; i < size; i++)
+    inv[sol[i]] = i;
+
+#define Touch(v)  if (!touched[v]) { touched[v] = 1; nb_touched++; }
+
+  for(p = delta_txt; *p; p = q)
+    {
+      if ((q = strchr(p, '\n')) != NULL)
+	*q++ = '\0';
+      else
+	q = p + strlen(p);
+
+      if (sscanf(p, " %c%n", &m, &n) != 1 || m == '#')
+	continue;
+
+      if ((m != 'a' && m != 'b') || sscanf(p + n, "%d %d %d", &i, &j, &x) != 3 ||
+	  i < 1 || i > size || j < 1 || j > size)
+	{
+	  fprintf(stderr, "bad delta line: %s\n", p);
+	  return -2;
+	}
+      i--;
+      j--;
+      mat = (m == 'a') ? qap_info.a : qap_info.b;
+
+      if (mat == mat_A)		/* indexed by vars */
+	{
+	  cost += (x - mat[i][j]) * mat_B[sol[i]][sol[j]];
+	  Touch(i);
+	  Touch(j);
+	}
+      else			/* indexed by values */
+	{
+	  cost += (x - mat[i][j]) * mat_A[inv[i]][inv[j]];
+	  Touch(inv[i]);
+	  Touch(inv[j]);
+	}
+      mat[i][j] = x;
+    }
+
+#undef Touch
+
+#if SPEED == 2
+  if (2 * nb_touched >= size)
+    {
+      for(i = 0; i < size; i++)
+	for(j = i + 1; j < size; j++)
+	  delta[i][j] = Compute_Delta(i, j);
+    }
+  else
+    {
+      for(k = 0; k < size; k++)
+	if (touched[k])
+	  {
+	    for(i = 0; i < k; i++)
+	      delta[i][k] = Compute_Delta(i, k);
+	    for(i = k + 1; i < size; i++)
+	      delta[k][i] = Compute_Delta(k, i);
+	  }
+    }
+#endif
+
+  return cost;
+}
+
+
+
+
 int param_needed = -1;		/* overwrite var of main.c */
 
 
@@ -149,7 +149,7 @@ void QCP_Load_Problem(char *file_name, QCPInfo *qi, int justVar, int *sizePb, in
   char c[5] = "";
   FILE *f;
 
-  if ((f = fopen(file_name, "rt")) == NULL) 
+  if ((f = Open_Instance(file_name)) == NULL) 
     {
       perror(file_name);
       exit(1);
@@ -15,8 +15,7 @@
 
 #define QCP_NO_MAIN
 #include "quasigroup-utils.c"
-
-AdData *p_ad0;
+#include "alldiff-utils.c"
 
 /*-----------*
  * Constants *
@@ -35,6 +34,9 @@ static int	nbVar;		/* number of variables in p_ad->sol */
 static QCPInfo	qcp_info;
 static int	*sol;		/* copy of p_ad->sol */
 
+static AllDiff	*row_ad;	/* all-different constraint of each row */
+static AllDiff	*col_ad;	/* all-different constraint of each column */
+
 static int	**constraints;
 static int	**domains;
 static int	**matrix;
@@ -103,6 +105,8 @@ int inDomain(int val, int *tab)
  */
 void Solve(AdData *p_ad)
 {
+  sol = p_ad->sol;
+
   if (constraints == NULL)		/* matrices not yet read */
     {
       QCP_Load_Problem(p_ad->param_file, &qcp_info, 0, &nbVar, &size);  
@@ -111,102 +115,133 @@ void Solve(AdData *p_ad)
       matrix		= qcp_info.matrix;
       variables		= qcp_info.variables;
       coordinates	= qcp_info.coordinates;
-      p_ad->size	= nbVar;
 
-      sol = malloc(nbVar * sizeof(int));
-      int *values = malloc(size * sizeof(int));
+      row_ad = malloc(size * sizeof(AllDiff));
+      col_ad = malloc(size * sizeof(AllDiff));
+      if (row_ad == NULL || col_ad == NULL)
+	{
+	  fprintf(stderr, "%s:%d malloc failed\n", __FILE__, __LINE__);
+	  exit(1);
+	}
+
+      for (int i = 0; i < size; i++)
+	{
+	  AllDiff_Init(&row_ad[i], size, 0, 0);
+	  AllDiff_Init(&col_ad[i], size, 0, 0);
+	}
 
       //sort(constraints, domains);
 
 #if defined DEBUG
-      printf("\nMATRIX\n");
-      QCP_Display_Matrix(matrix, size);
+      if (p_ad->debug)
+	{
+	  printf("\nMATRIX\n");
+	  QCP_Display_Matrix(matrix, size);
       
-      printf("\nVARIABLES\n");
-      QCP_Display_Matrix(variables, size);
+	  printf("\nVARIABLES\n");
+	  QCP_Display_Matrix(variables, size);
       
-      printf("\nCONSTRAINTS\n");
-      for (int i = 0; i < 2*size; i++)
-      	{
-      	  if (i < size)
-      	    printf("row %d : ", i);
-      	  else
-      	    printf("column %d : ", i-size);
+	  printf("\nCONSTRAINTS\n");
+	  for (int i = 0; i < 2*size; i++)
+	    {
+	      if (i < size)
+		printf("row %d : ", i);
+	      else
+		printf("column %d : ", i-size);
 	  
-      	  for (int j = 1; j <= constraints[i][0]; j++)
-	    printf("%d ", constraints[i][j]);
-      	  printf("\n");
-      	}
+	      for (int j = 1; j <= constraints[i][0]; j++)
+		printf("%d ", constraints[i][j]);
+	      printf("\n");
+	    }
       
-      printf("\nDOMAINS\n");
-      for (int i = 0; i < nbVar; i++)
-      	{
-      	  printf("Var %d (%d) : ", i, domains[i][0]);
-      	  for (int j = 1; j <= domains[i][0]; j++)
-      	    printf("%d ", domains[i][j]);
-      	  printf("\n");
-      	}
-      printf("\n");
-#endif /* !DEBUG */
-
-      for (int row = 0; row < size; row++)
-	{
-	  for (int i = 0; i < size; i++)
-	    values[i] = 0;
-	    	    
-	  for (int col = 0; col < size; col++)
-	    if (matrix[row][col] != -1)
-	      values[matrix[row][col]] = 1;
-	
-	  for (int index = 1; index <= constraints[row][0]; index++)
+	  printf("\nDOMAINS\n");
+	  for (int i = 0; i < nbVar; i++)
 	    {
-	      for (int i = index-1; i < size; i++)
-		{
-		  if (values[i] == 0)
-		    {
-		      int var = constraints[row][index];
-		      /* if (inDomain(i, domains[var]) == 1) */
-		      /* 	{ */
-		      /* 	  p_ad->sol[var] = i; */
-		      /* 	  values[i] = 1; */
-		      /* 	  break; */
-		      /* 	} */
-		      p_ad->sol[var] = i;
-		      values[i] = 1;
-		      break;
-		    }
-		}
+	      printf("Var %d (%d) : ", i, domains[i][0]);
+	      for (int j = 1; j <= domains[i][0]; j++)
+		printf("%d ", domains[i][j]);
+	      printf("\n");
 	    }
+	  printf("\n");
 	}
-
-      free (values);
+#endif /* !DEBUG */
     }  
-  
-  for (int i = 0; i < nbVar; i++)
-    sol[i] = p_ad->sol[i];
-
-#if defined DEBUG
-  printf("INITIAL VALUES\n");
-  for (int i = 0; i < nbVar; i++)
-    printf("%d ", p_ad->sol[i]);
-  printf("\n");
-#endif
 
   Ad_Solve(p_ad);
-  p_ad0 = p_ad;
+}
+
+
+/*
+ *  FREE_PROBLEM
+ *
+ *  Forgets the current instance (the next Solve reads p_ad->param_file).
+ */
+void Free_Problem(AdData *p_ad)
+{
+  if (constraints == NULL)
+    return;
 
-  // copy of matrix and variables before deleting qcp_info
-  // we need them for solution checking
-  matrix = QCP_Alloc_Matrix(size);
-  variables = QCP_Alloc_Matrix(size);
   for (int i = 0; i < size; i++)
-    for (int j = 0; j < size; j++)
-      {
-	matrix[i][j] = qcp_info.matrix[i][j]; 
-	variables[i][j] = qcp_info.variables[i][j];
-      }  
+    {
+      AllDiff_Free(&row_ad[i]);
+      AllDiff_Free(&col_ad[i]);
+    }
+  free(row_ad);
+  free(col_ad);
 
   QCP_Free_Info(&qcp_info, nbVar, size);
+  constraints = NULL;
+}
+
+
+/*
+ *  SET_INIT_CONFIGURATION
+ *
+ *  Fills the holes of each row with the values missing in this row
+ *  (in a random order): the rows are then all-different.
+ */
+void Set_Init_Configuration(AdData *p_ad)
+{
+  int values[size];
+
+  for (int row = 0; row < size; row++)
+    {
+      int nb = 0;
+
+      for (int i = 0; i < size; i++)
+	values[i] = 0;
+	    	    
+      for (int col = 0; col < size; col++)
+	if (matrix[row][col] != -1)
+	  values[matrix[row][col]] = 1;
+
+      for (int i = 0; i < size; i++)
+	if (values[i] == 0)
+	  values[nb++] = i;
+
+      for (int index = 1; index <= constraints[row][0]; index++)
+	{
+	  int k = Random(nb);
+	  p_ad->sol[constraints[row][index]] = values[k];
+	  values[k] = values[--nb];
+	}
+    }
+}
+
+
+/*
+ *  CHECK_INIT_CONFIGURATION
+ *
+ *  Checks if an initial configuration is valid
+ */
+void Check_Init_Configuration(AdData *p_ad)
+{
+  for (int i = 0; i < p_ad->size; i++)
+    if ((unsigned) p_ad->sol[i] >= (unsigned) size)
+      {
+	fprintf(stderr, "not a valid configuration, error at [%d] = %d\n", i, p_ad->sol[i]);
+	exit(1);
+      }
 }
 
 
@@ -216,62 +251,37 @@ void Solve(AdData *p_ad)
  *  Returns the total cost of the current solution.
  *  Also computes errors on constraints for subsequent calls to
  *  Cost_On_Variable, Cost_If_Swap and Executed_Swap.
+ *
+ *  The cost is the number of doubloons in rows and columns. Each row and
+ *  each column is an all-different constraint (see alldiff-utils.c)
+ *  containing the fixed values and the values of its holes.
  */
 int Cost_Of_Solution(int should_be_recorded)
 {
   int occurences = 0;
   int n = size;
-  int line[n];
 
-  /* number of doubloons in rows */
-  for (int row = 0; row < n; row++)
+  for (int i = 0; i < n; i++)
     {
-      for (int i = 0; i < n; i++)
-	line[i] = 0;
+      AllDiff_Clear(&row_ad[i]);
+      AllDiff_Clear(&col_ad[i]);
+    }
 
-      for (int col = 0; col < n; col++)
-	{
-	  if (matrix[row][col] != -1)
-	    {
-	      if (line[matrix[row][col]] == 0)
-		line[matrix[row][col]] = 1;
-	      else
-		occurences++;
-	    }
-	  else
-	    {
-	      if (line[sol[variables[row][col]]] == 0)
-		line[sol[variables[row][col]]] = 1;
-	      else
-		occurences++;
-	    }
-	}
-    }      
-  /* number of doubloons in columns */
-  for (int col = 0; col < n; col++)
-    {
-      for (int i = 0; i < n; i++)
-	line[i] = 0;
+  for (int row = 0; row < n; row++)
+    for (int col = 0; col < n; col++)
+      {
+	int x = matrix[row][col];
+
+	if (x == -1)
+	  x = sol[variables[row][col]];
+
+	AllDiff_Add(&row_ad[row], x);
+	AllDiff_Add(&col_ad[col], x);
+      }
+
+  for (int i = 0; i < n; i++)
+    occurences += AllDiff_Cost(&row_ad[i]) + AllDiff_Cost(&col_ad[i]);
 
-      for (int row = 0; row < n; row++)
-	{
-	  if (matrix[row][col] != -1)
-	    {
-	      if (line[matrix[row][col]] == 0)
-		line[matrix[row][col]] = 1;
-	      else
-		occurences++;
-	    }
-	  else
-	    {
-	      if (line[sol[variables[row][col]]] == 0)
-		line[sol[variables[row][col]]] = 1;
-	      else
-		occurences++;
-	    }
-	}
-    }      
-  
   return occurences;
 }
 
@@ -283,6 +293,9 @@ int Cost_Of_Solution(int should_be_recorded)
  *  Returns INT_MAX if:  
  *	- variables x and y are neither on the same row nor the same column.
  *	- value of x is not in the domain of y and vice versa.
+ *
+ *  On the same row, the row is unchanged and each of both columns has one
+ *  value replaced (and symmetrically on the same column).
  */
 int Cost_If_Swap(int current_cost, int y, int x)
 {
@@ -295,343 +308,39 @@ int Cost_If_Swap(int current_cost, int y, int x)
   int rowY = coordinates[y].row;
   int colY = coordinates[y].col;
 
-  int n = size;
+  int valX = sol[x];
+  int valY = sol[y];
 
-  //printf("COST IF SWAP %d (%d) and %d (%d) : ", x, sol[x], y, sol[y]);
+  if (!inDomain(valY, domains[x]) || !inDomain(valX, domains[y]))
+    return INT_MAX;
 
-  if (!inDomain(sol[y], domains[x]))
-    {
-      /* printf("MAX y not in Dom(x)\n"); */
-      return INT_MAX;
-    }
-  else
-    {
-      if (!inDomain(sol[x], domains[y]))
-	{
-	  /* printf("MAX x not in Dom(y)\n"); */
-	  return INT_MAX;
-	}
-    }
-  
-  // Does x and y are on the same row?
   if (rowX == rowY)
-    {
-      int costColX = 0;
-      int costColY = 0;
-      int futureCostColX = 0;
-      int futureCostColY = 0;
-
-      int lineX[n];
-      int lineY[n];
-
-      for (int i = 0; i < n; i++)
-	{
-	  lineX[i] = 0;
-	  lineY[i] = 0;
-	}
-
-      // Cost of column for X and Y before swap (i.e., current state)
-      for (int row = 0; row < n; row++)
-	{
-	  if (matrix[row][colX] != -1)
-	    {
-	      if (lineX[matrix[row][colX]] == 0)
-		lineX[matrix[row][colX]] = 1;
-	      else
-		costColX++;
-	    }
-	  else
-	    {
-	      if (lineX[sol[variables[row][colX]]] == 0)
-		lineX[sol[variables[row][colX]]] = 1;
-	      else
-		costColX++;
-	    }
+    return current_cost
+      + AllDiff_Delta_Replace(&col_ad[colX], valX, valY)
+      + AllDiff_Delta_Replace(&col_ad[colY], valY, valX);
 
-	  if (matrix[row][colY] != -1)
-	    {
-	      if (lineY[matrix[row][colY]]  == 0)
-		lineY[matrix[row][colY]] = 1;
-	      else
-		costColY++;
-	    }
-	  else
-	    {
-	      if (lineY[sol[variables[row][colY]]] == 0)
-		lineY[sol[variables[row][colY]]] = 1;
-	      else
-		costColY++;
-	    }
-	}
+  if (colX == colY)
+    return current_cost
+      + AllDiff_Delta_Replace(&row_ad[rowX], valX, valY)
+      + AllDiff_Delta_Replace(&row_ad[rowY], valY, valX);
 
-      for (int i = 0; i < n; i++)
-	{
-	  lineX[i] = 0;
-	  lineY[i] = 0;
-	}
-
-      // Cost of these columns after swapping X and Y
-      for (int row = 0; row < n; row++)
-	{
-	  int col;
-	  if (row == rowX)
-	    col = colY;
-	  else
-	    col = colX;
-	  
-	  if (matrix[row][col] != -1)
-	    {
-	      if (lineX[matrix[row][col]] == 0)
-		lineX[matrix[row][col]] = 1;
-	      else
-		futureCostColX++;
-	    }
-	  else
-	    {
-	      if (lineX[sol[variables[row][col]]] == 0)
-		lineX[sol[variables[row][col]]] = 1;
-	      else
-		futureCostColX++;
-	    }
-	  
-	  if (row == rowY)
-	    col = colX;
-	  else
-	    col = colY;
-	  
-	  if (matrix[row][col] != -1)
-	    {
-	      if (lineY[matrix[row][col]] == 0)
-		lineY[matrix[row][col]] = 1;
-	      else
-		futureCostColY++;
-	    }
-	  else
-	    {
-	      if (lineY[sol[variables[row][col]]] == 0)
-		lineY[sol[variables[row][col]]] = 1;
-	      else
-		futureCostColY++;
-	    }
-	}
-#if DEBUG
-       printf("cost if swap row %d, (c:%d, fx:%d, x:%d, fy:%d, y:%d)\n",
-       	      current_cost + (futureCostColX - costColX) + (futureCostColY - costColY), current_cost, futureCostColX, costColX, futureCostColY, costColY);
-#endif
-      return (current_cost + (futureCostColX - costColX) + (futureCostColY - costColY));
-    }
-  // X and Y are not on the same row. Same column?
-  else
-    {
-      if (colX == colY)
-	{
-	  int costRowX = 0;
-	  int costRowY = 0;
-	  int futureCostRowX = 0;
-	  int futureCostRowY = 0;
-	  
-	  int lineX[n];
-	  int lineY[n];
-
-	  for (int i = 0; i < n; i++)
-	    {
-	      lineX[i] = 0;
-	      lineY[i] = 0;
-	    }
-	  
-	  // Cost of row for X and Y before swap (i.e., current state)
-	  for (int col = 0; col < n; col++)
-	    {
-	      if (matrix[rowX][col] != -1)
-		{
-		  if (lineX[matrix[rowX][col]] == 0)
-		    lineX[matrix[rowX][col]] = 1;
-		  else
-		    costRowX++;
-		}
-	      else
-		{
-		  if (lineX[sol[variables[rowX][col]]] ==0)
-		    lineX[sol[variables[rowX][col]]] = 1;
-		  else
-		    costRowX++;
-		}
-		  
-	      if (matrix[rowY][col] != -1)
-		{
-		  if (lineY[matrix[rowY][col]] == 0)
-		    lineY[matrix[rowY][col]] = 1;
-		  else		  
-		    costRowY++;
-		}
-	      else
-		{
-		  if (lineY[sol[variables[rowY][col]]] == 0)
-		    lineY[sol[variables[rowY][col]]] = 1;
-		  else
-		    costRowY++;
-		}
-	    }
-
-	  for (int i = 0; i < n; i++)
-	    {
-	      lineX[i] = 0;
-	      lineY[i] = 0;
-	    }
-	  
-	  // Cost of these rows after swapping X and Y
-	  for (int col = 0; col < n; col++)
-	    {
-	      int row;
-	      if (col == colX)
-		row = rowY;
-	      else
-		row = rowX;
-	      
-	      if (matrix[row][col] != -1)
-		{
-		  if (lineX[matrix[row][col]] == 0)
-		    lineX[matrix[row][col]] = 1;
-		  else
-		    futureCostRowX++;
-		}
-	      else
-		{
-		  if (lineX[sol[variables[row][col]]] == 0)
-		    lineX[sol[variables[row][col]]] = 1;
-		  else
-		    futureCostRowX++;
-		}  
-	      
-	      if (col == colY)
-		row = rowX;
-	      else
-		row = rowY;
-	      
-	      if (matrix[row][col] != -1)
-		{
-		  if (lineY[matrix[row][col]] == 0)
-		    lineY[matrix[row][col]] = 1;
-		  else
-		    futureCostRowY++;
-		}
-	      else
-		{
-		  if (lineY[sol[variables[row][col]]] == 0)
-		    lineY[sol[variables[row][col]]] = 1;
-		  else
-		    futureCostRowY++;
-		}
-	    }
-	  
-#ifdef DEBUG
-	  printf("cost if swap column %d, (c:%d, fx:%d, x:%d, fy:%d, y:%d)\n",
-	  	 current_cost + (futureCostRowX - costRowX) + (futureCostRowY - costRowY), current_cost, futureCostRowX, costRowX, futureCostRowY, costRowY);
-#endif
-	  return (current_cost + (futureCostRowX - costRowX) + (futureCostRowY - costRowY));
-	}
-      // X and Y are neither on the same row nor the same column: we cannot swap them!
-      else
-	{
-	  /* printf("MAX not same row/col\n"); */
-	  return INT_MAX;
-	}
-    }  
+  // X and Y are neither on the same row nor the same column: we cannot swap them!
+  return INT_MAX;
 }
 
 
 /*
  *  COST_ON_VARIABLE
  *
- *  Evaluates the error on a variable.
+ *  Evaluates the error on a variable: the number of other cells with
+ *  the same value on its row and on its column.
  */
 int Cost_On_Variable(int k)
 {
   int rowK = coordinates[k].row;
   int colK = coordinates[k].col;
 
-  int errors = 0;
-  //int line[size];
-
-  // same value of k on its column
-  for (int row = 0; row < size; row++)
-    {
-      if (row == rowK)
-	continue;
-      if (matrix[row][colK] != -1)
-	{
-	  if (matrix[row][colK] == sol[k])
-	    errors++;
-	}
-      else
-	{
-	  if (sol[variables[row][colK]] == sol[k])
-	    errors++;
-	}
-    }
-
-  // same value of k on its row
-  for (int col = 0; col < size; col++)
-    {
-      if (col == colK)
-	continue;
-      if (matrix[rowK][col] != -1)
-  	{
-  	  if (matrix[rowK][col] == sol[k])
-  	    errors++;
-  	}
-      else
-  	{
-  	  if (sol[variables[rowK][col]] == sol[k])
-	    errors++;
-  	}
-    }
-
-  /* // errors on column of k */
-  /* for (int row = 0; row < size; row++) */
-  /*   { */
-  /*     for (int i = 0; i < size; i++) */
-  /* 	line[i] = 0; */
-
-  /*     if (matrix[row][colK] != -1) */
-  /* 	{ */
-  /* 	  if (line[matrix[row][colK]] == 0) */
-  /* 	    line[matrix[row][colK]] = 1; */
-  /* 	  else */
-  /* 	    errors++; */
-  /* 	} */
-  /*     else */
-  /* 	{ */
-  /* 	  if (line[sol[k]] == 0) */
-  /* 	    line[sol[k]] = 1; */
-  /* 	  else */
-  /* 	    errors++; */
-  /* 	} */
-  /*   } */
-
-  /* // errors on row of k */
-  /* for (int col = 0; col < size; col++) */
-  /*   { */
-  /*     for (int i = 0; i < size; i++) */
-  /* 	line[i] = 0; */
-
-  /*     if (matrix[rowK][col] != -1) */
-  /* 	{ */
-  /* 	  if (line[matrix[rowK][col]] == 0) */
-  /* 	    line[matrix[rowK][col]] = 1; */
-  /* 	  else */
-  /* 	    errors++; */
-  /* 	} */
-  /*     else */
-  /* 	{ */
-  /* 	  if (line[sol[k]] == 0) */
-  /* 	    line[sol[k]] = 1; */
-  /* 	  else */
-  /* 	    errors++; */
-  /* 	} */
-  /*   } */
-
-  return errors;
+  return AllDiff_Nb_Occ(&row_ad[rowK], sol[k]) - 1 + AllDiff_Nb_Occ(&col_ad[colK], sol[k]) - 1;
 }
 
 
@@ -642,14 +351,26 @@ int Cost_On_Variable(int k)
  */
 void Executed_Swap(int x, int y)
 {
-  printf("swapping var %d (%d) and %d (%d)\n", x, sol[x], y, sol[y]);
-  Display_Solution(p_ad0);
-#if 0
-  int tmp = sol[x];
-  sol[x] = sol[y];
-  sol[y] = tmp;
-  //printf("swapping var %d (%d) and %d (%d)\n", x, sol[x], y, sol[y]);
-#endif
+  int rowX = coordinates[x].row;
+  int colX = coordinates[x].col;
+
+  int rowY = coordinates[y].row;
+  int colY = coordinates[y].col;
+
+  int valX = sol[x];		/* swap already executed */
+  int valY = sol[y];
+
+  if (rowX != rowY)
+    {
+      AllDiff_Replace(&row_ad[rowX], valY, valX);
+      AllDiff_Replace(&row_ad[rowY], valX, valY);
+    }
+
+  if (colX != colY)
+    {
+      AllDiff_Replace(&col_ad[colX], valY, valX);
+      AllDiff_Replace(&col_ad[colY], valX, valY);
+    }
 }
 
 
@@ -657,29 +378,23 @@ void Executed_Swap(int x, int y)
  *  RESET
  *
  * Performs a reset (returns the new cost or -1 if unknown or some other data are not updated)
- *
+ * Swaps 2 holes of a random row, n times.
  */
 int Reset(int n, AdData *p_ad)
 {
-  int randRow;
-  int randCol;
-
+  int randRow, nb;
   int randX, randY;
   int tmp;
 
-  for (int i = 0; i < (int)ceil((float)n / 2); i++)
+  for (int i = 0; i < n; i++)
     {
       randRow = Random(size);
-      randX = Random(constraints[randRow][0]);
-      randY = Random(constraints[randRow][0]);
-      
-      tmp = p_ad->sol[randX];
-      p_ad->sol[randX] = p_ad->sol[randY];
-      p_ad->sol[randY] = tmp;
-      
-      randCol = Random(size);
-      randX = Random(constraints[randCol+n][0]);
-      randY = Random(constraints[randCol+n][0]);
+      nb = constraints[randRow][0];
+      if (nb < 2)
+	continue;
+
+      randX = constraints[randRow][1 + Random(nb)];
+      randY = constraints[randRow][1 + Random(nb)];
       
       tmp = p_ad->sol[randX];
       p_ad->sol[randX] = p_ad->sol[randY];
@@ -753,9 +468,6 @@ int Check_Solution(AdData *p_ad)
 	      else
 		{
 		  printf("ERROR at (%d, %d): doubloon row mat\n", row, col);
-		  QCP_Free_Matrix(matrix, size);
-		  QCP_Free_Matrix(variables, size);
-		  free (sol);  
 		  return 0;
 		}
 	    }
@@ -766,9 +478,6 @@ int Check_Solution(AdData *p_ad)
 	      else
 		{
 		  printf("ERROR at (%d, %d): doubloon row var\n", row, col);
-		  QCP_Free_Matrix(matrix, size);
-		  QCP_Free_Matrix(variables, size);
-		  free (sol);  
 		  return 0;
 		}
 	    }  
@@ -789,9 +498,6 @@ int Check_Solution(AdData *p_ad)
 	      else
 		{
 		  printf("ERROR at (%d, %d): doubloon col mat\n", row, col);
-		  QCP_Free_Matrix(matrix, size);
-		  QCP_Free_Matrix(variables, size);
-		  free (sol);  
 		  return 0;
 		}
 	    }
@@ -802,18 +508,12 @@ int Check_Solution(AdData *p_ad)
 	      else
 		{
 		  printf("ERROR at (%d, %d): doubloon col var\n", row, col);
-		  QCP_Free_Matrix(matrix, size);
-		  QCP_Free_Matrix(variables, size);
-		  free (sol);  
 		  return 0;
 		}
 	    }  
 	}
     }
-  
-  QCP_Free_Matrix(matrix, size);
-  QCP_Free_Matrix(variables, size);
-  free (sol);  
+
   return 1;
 }
 
@@ -16,13 +16,17 @@
  * Constants *
  *-----------*/
 
+#define DIAG16_MAX_SIZE   65535	/* up to this size diagonal counters are 16 bits */
+
+#define INIT_MAX_TRIES    128	/* greedy init: max nb of tries to find a free column */
+
 /*-------*
  * Types *
  *-------*/
 
 typedef struct
 {
-  int *err;
+  int  d;			/* diagonal no */
   int  to_add;
 }UpdateErr;
 
@@ -37,13 +41,20 @@ static int *sol;		/* copy of p_ad->sol */
 static int size1;		/* size1: size-1 */
 static int nb_diag;		/* nb of diagonals in a same direction */
 
-static int *err_d1;		/* errors on diagonals 1 (\) */
-static int *err_d2;		/* errors on diagonals 2 (/) */
+static int diag16;		/* true if diagonal counters are 16 bits (else 32 bits) */
+static void *err_d1;		/* errors on diagonals 1 (\) */
+static void *err_d2;		/* errors on diagonals 2 (/) */
+
+static int start_j;		/* first j returned by Next_J (random) */
 
 #define D1(i, j)      (i + size1 - j)
 #define D2(i, j)      (i + j)
-#define ErrD1(i, j)   (err_d1[D1(i, j)])
-#define ErrD2(i, j)   (err_d2[D2(i, j)])
+#define ErrD1(i, j)   Get_Err(err_d1, D1(i, j))
+#define ErrD2(i, j)   Get_Err(err_d2, D2(i, j))
+#define IncD1(i, j)   Add_Err(err_d1, D1(i, j), +1)
+#define IncD2(i, j)   Add_Err(err_d2, D2(i, j), +1)
+#define DecD1(i, j)   Add_Err(err_d1, D1(i, j), -1)
+#define DecD2(i, j)   Add_Err(err_d2, D2(i, j), -1)
 
 
 /*------------*
@@ -77,6 +88,18 @@ static int *err_d2;		/* errors on diagonals 2 (/) */
  *
  *  The projection on a variable at i (i.e. a queen at i,j):
  *  err_var[i] = F(err_d1[D1(i,j)]) + F(err_d2[D2(i,j)])
+ *
+ *  Since a diagonal contains at most ad.size queens, the counters are
+ *  stored on 16 bits while ad.size <= DIAG16_MAX_SIZE (on 32 bits else).
+ *
+ *  For large sizes almost all queens are without conflict, the engine
+ *  conflict set is used (see Ad_Conflict_Add). The other queen of a diagonal
+ *  which becomes conflicting is not known, it is thus not added by 
+ *  Executed_Swap (the engine rebuilds the set when it runs out).
+ *
+ *  The initial configuration is greedy: each row takes a random free
+ *  column whose diagonals are free (after INIT_MAX_TRIES it takes the last
+ *  tried column). This gives very few conflicts in O(n) expected time.
  */
 
 #if 0
@@ -91,6 +114,30 @@ F(int x)
 
 
 
+
+/*
+ *  GET_ERR / ADD_ERR
+ *
+ *  Access to a diagonal counter (16 or 32 bits).
+ */
+
+static __inline__ int
+Get_Err(void *t, int d)
+{
+  return (diag16) ? ((unsigned short *) t)[d] : ((int *) t)[d];
+}
+
+static __inline__ void
+Add_Err(void *t, int d, int v)
+{
+  if (diag16)
+    ((unsigned short *) t)[d] += v;
+  else
+    ((int *) t)[d] += v;
+}
+
+
+
 /*
  *  SOLVE
  *
@@ -107,10 +154,14 @@ Solve(AdData *p_ad)
 
   nb_diag = 2 * size - 1;
 
+  diag16 = (size <= DIAG16_MAX_SIZE);
+
   if (err_d1 == NULL)
     {
-      err_d1 = (int *) malloc(nb_diag * sizeof(int));
-      err_d2 = (int *) malloc(nb_diag * sizeof(int));
+      int elem_size = (diag16) ? sizeof(unsigned short) : sizeof(int);
+
+      err_d1 = malloc(nb_diag * elem_size);
+      err_d2 = malloc(nb_diag * elem_size);
       if (err_d1 == NULL || err_d2 == NULL)
 	{
 	  fprintf(stderr, "%s:%d malloc failed\n", __FILE__, __LINE__);
@@ -122,6 +173,83 @@ Solve(AdData *p_ad)
 }
 
 
+/*
+ *  CLEAR_ERRORS
+ *
+ *  Resets all diagonal counters.
+ */
+
+static void
+Clear_Errors(void)
+{
+  int elem_size = (diag16) ? sizeof(unsigned short) : sizeof(int);
+
+  memset(err_d1, 0, nb_diag * elem_size);
+  memset(err_d2, 0, nb_diag * elem_size);
+}
+
+
+
+
+/*
+ *  SET_INIT_CONFIGURATION
+ *
+ *  Sets a greedy initial configuration (few conflicts).
+ */
+
+void
+Set_Init_Configuration(AdData *p_ad)
+{
+  int i, j, k, t;
+
+  Clear_Errors();
+
+  for(i = 0; i < size; i++)
+    sol[i] = i;
+
+  for(i = 0; i < size; i++)	/* sol[i..size-1] are the free columns */
+    {
+      t = 0;
+      do
+	{
+	  k = i + Random(size - i);
+	  j = sol[k];
+	}
+      while((ErrD1(i, j) || ErrD2(i, j)) && ++t < INIT_MAX_TRIES);
+
+      sol[k] = sol[i];
+      sol[i] = j;
+      IncD1(i, j);
+      IncD2(i, j);
+    }
+}
+
+
+
+
+/*
+ *  CHECK_INIT_CONFIGURATION
+ *
+ *  Checks if an initial configuration is valid
+ */
+
+void
+Check_Init_Configuration(AdData *p_ad)
+{
+  int i = Random_Permut_Check(p_ad->sol, p_ad->size, p_ad->actual_value, p_ad->base_value);
+  if (i >= 0)
+    {
+      fprintf(stderr, "not a valid permutation, error at [%d] = %d\n", i, p_ad->sol[i]);
+      Random_Permut_Repair(p_ad->sol, p_ad->size, p_ad->actual_value, p_ad->base_value);
+      printf("possible repair:\n");
+      Display_Solution(p_ad);
+      exit(1);
+    }
+}
+
+
+
+
 /*
  *  COST_OF_SOLUTION
  *
@@ -135,23 +263,22 @@ Cost_Of_Solution(int should_be_recorded)
 {
   int d, i, j, er, r;
 
-  memset(err_d1, 0, nb_diag * sizeof(int));
-  memset(err_d2, 0, nb_diag * sizeof(int));
+  Clear_Errors();
 
   for(i = 0; i < size; i++)
     {
       j = sol[i];
-      ErrD1(i, j)++;
-      ErrD2(i, j)++;
+      IncD1(i, j);
+      IncD2(i, j);
     }
 
   r = 0;
   for(d = 1; d < nb_diag - 1; d++)
     {
-      er = err_d1[d];
+      er = Get_Err(err_d1, d);
       r += F(er);
 
-      er = err_d2[d];
+      er = Get_Err(err_d2, d);
       r += F(er);
     }
 
@@ -185,24 +312,49 @@ Cost_On_Variable(int i)
 
 
 
+/*
+ *  NEXT_J
+ *
+ *  Returns all j from a random start (thus first_best selects a random 
+ *  improving swap). In exhaustive mode use the default order.
+ */
+
+int
+Next_J(int i, int j, int exhaustive)
+{
+  if (exhaustive)
+    return (j < 0) ? i + 1 : j + 1;
+
+  if (j < 0)
+    return start_j = Random(size);
+
+  if (++j == size)
+    j = 0;
+
+  return (j == start_j) ? size : j;
+}
+
+
+
+
 /*
  *  COST_IF_SWAP
  *
  *  Evaluates the new total cost for a swap.
  */
 
-#define Update_Error_Table(derr, toadd)		\
+#define Update_Error_Table(diag, toadd)		\
   p = start;					\
   for(;;)					\
     {						\
       if (p == end)				\
 	{					\
-	  p->err = derr;			\
+	  p->d = diag;				\
 	  p->to_add = toadd;			\
 	  end++;			       	\
  	  break;				\
 	}					\
-      if (p->err == derr)			\
+      if (p->d == diag)				\
 	{					\
 	  p->to_add += toadd;			\
 	  break;				\
@@ -216,7 +368,7 @@ Cost_If_Swap(int current_cost, int i1, int i2)
   int r, x;
   int j1, j2;
   UpdateErr update_tbl[8], *start, *end, *p;
-  int *err;
+  void *err;
 
   end = update_tbl;
 
@@ -225,18 +377,18 @@ Cost_If_Swap(int current_cost, int i1, int i2)
 
 				/* update info for diagonal 1 */
   start = update_tbl;
-  Update_Error_Table(&ErrD1(i1, j1), -1);
-  Update_Error_Table(&ErrD1(i2, j2), -1);
-  Update_Error_Table(&ErrD1(i1, j2), +1);
-  Update_Error_Table(&ErrD1(i2, j1), +1);
+  Update_Error_Table(D1(i1, j1), -1);
+  Update_Error_Table(D1(i2, j2), -1);
+  Update_Error_Table(D1(i1, j2), +1);
+  Update_Error_Table(D1(i2, j1), +1);
 
 
 				/* update info diagonal 2 */
   start = end;
-  Update_Error_Table(&ErrD2(i1, j1), -1);
-  Update_Error_Table(&ErrD2(i2, j2), -1);
-  Update_Error_Table(&ErrD2(i1, j2), +1);
-  Update_Error_Table(&ErrD2(i2, j1), +1);
+  Update_Error_Table(D2(i1, j1), -1);
+  Update_Error_Table(D2(i2, j2), -1);
+  Update_Error_Table(D2(i1, j2), +1);
+  Update_Error_Table(D2(i2, j1), +1);
 
 
 
@@ -244,28 +396,14 @@ Cost_If_Swap(int current_cost, int i1, int i2)
   printf("diagonals to update for swap %d/%d and %d/%d :\n",
 	 i1, j1, i2, j2);
   for(p = update_tbl; p != end; p++)
-    {
-      err = p->err;
-      if (p < start)
-	{
-	  x = err - err_d1;
-	  r = 1;
-	}
-      else
-	{
-	  x = err - err_d2;
-	  r = 2;
-	}
-
-      printf("on d%d[%d] add: %d\n", r, x, p->to_add);
-    }
+    printf("on d%d[%d] add: %d\n", (p < start) ? 1 : 2, p->d, p->to_add);
 #endif  
   r = current_cost;
 
   for(p = update_tbl; p != end; p++)
     {
-      err = p->err;
-      x = *err;
+      err = (p < start) ? err_d1 : err_d2;
+      x = Get_Err(err, p->d);
       r -= F(x);
 
       x += p->to_add;
@@ -292,15 +430,86 @@ Executed_Swap(int i1, int i2)
   j1 = sol[i2];		/* swap already executed */
   j2 = sol[i1];
 
-  ErrD1(i1, j1)--;
-  ErrD2(i1, j1)--;
-  ErrD1(i2, j2)--;
-  ErrD2(i2, j2)--;
+  DecD1(i1, j1);
+  DecD2(i1, j1);
+  DecD1(i2, j2);
+  DecD2(i2, j2);
 
-  ErrD1(i1, j2)++;
-  ErrD2(i1, j2)++;
-  ErrD1(i2, j1)++;
-  ErrD2(i2, j1)++;
+  IncD1(i1, j2);
+  IncD2(i1, j2);
+  IncD1(i2, j1);
+  IncD2(i2, j1);
+}
+
+
+
+
+/*
+ *  CONFLICTING_QUEEN
+ *
+ *  Returns a random queen in conflict (or -1 if none). The engine
+ *  conflict set is not maintained in exhaustive mode and can be empty
+ *  (e.g. when restarting from the best configuration): the rows are then
+ *  scanned from a random one.
+ */
+
+static int
+Conflicting_Queen(AdData *p_ad)
+{
+  int i, k, start;
+
+  if (p_ad->conflict_set && ad_nb_conflict > 0)
+    return ad_conflict[Random(ad_nb_conflict)];
+
+  start = Random(size);
+  for(k = 0; k < size; k++)
+    {
+      i = (start + k) % size;
+      if (Cost_On_Variable(i) > 0)
+	return i;
+    }
+
+  return -1;
+}
+
+
+
+
+/*
+ *  RESET
+ *
+ *  Performs a reset (returns the new cost or -1 if unknown)
+ *  Only queens in conflict are moved (at most n swaps). 
+ */
+
+int
+Reset(int n, AdData *p_ad)
+{
+  int i, j;
+  int cost = p_ad->total_cost;
+
+  if (p_ad->conflict_set && ad_nb_conflict > 0 && n > ad_nb_conflict)
+    n = ad_nb_conflict;
+
+  while(n--)
+    {
+      if ((i = Conflicting_Queen(p_ad)) < 0)
+	break;
+      j = Random(size);
+      if (i == j)
+	continue;
+
+      cost = Cost_If_Swap(cost, i, j);
+      Ad_Swap(i, j);
+      Executed_Swap(i, j);
+
+#if UNMARK_AT_RESET == 1
+      Ad_Un_Mark(i);
+      Ad_Un_Mark(j);
+#endif
+    }
+
+  return cost;
 }
 
 
@@ -320,6 +529,7 @@ Init_Parameters(AdData *p_ad)
   p_ad->size = p_ad->param;
 
   p_ad->first_best = 1;
+  p_ad->conflict_set = 1;
 
   if (p_ad->prob_select_loc_min == -1)
     p_ad->prob_select_loc_min = 6;
@@ -355,7 +565,10 @@ Init_Parameters(AdData *p_ad)
 int
 Check_Solution(AdData *p_ad)
 {
-  int i1, j1, i2, j2;
+  int size = p_ad->size;
+  int i1, j1, d;
+  int *row_d1, *row_d2;		/* row of the queen on each diagonal (or -1) */
+  int r = 1;
 
   int i = Random_Permut_Check(p_ad->sol, p_ad->size, p_ad->actual_value, p_ad->base_value);
   
@@ -365,19 +578,37 @@ Check_Solution(AdData *p_ad)
       return 0;
     }
 
+  row_d1 = (int *) malloc((2 * size - 1) * sizeof(int));
+  row_d2 = (int *) malloc((2 * size - 1) * sizeof(int));
+  if (row_d1 == NULL || row_d2 == NULL)
+    {
+      fprintf(stderr, "%s:%d malloc failed\n", __FILE__, __LINE__);
+      exit(1);
+    }
+
+  memset(row_d1, -1, (2 * size - 1) * sizeof(int));
+  memset(row_d2, -1, (2 * size - 1) * sizeof(int));
 
-  for(i1 = 0; i1 < p_ad->size; i1++)
+  for(i1 = 0; i1 < size && r; i1++)
     {
       j1 = p_ad->sol[i1];
-      for(i2 = i1 + 1; i2 < p_ad->size; i2++)
-	{
-	  j2 = p_ad->sol[i2];
-	  if (abs(j2 - j1) == i2 - i1)
-	    {
-	      printf("ERROR conflict %d/%d and %d/%d\n", i1, j1, i2, j2);
-	      return 0;
-	    }
-	}  
+
+      d = i1 + size - 1 - j1;
+      if ((i = row_d1[d]) >= 0)
+	r = 0;
+      row_d1[d] = i1;
+
+      d = i1 + j1;
+      if (r && (i = row_d2[d]) >= 0)
+	r = 0;
+      row_d2[d] = i1;
+
+      if (!r)
+	printf("ERROR conflict %d/%d and %d/%d\n", i, p_ad->sol[i], i1, j1);
     }
-  return 1;
+
+  free(row_d1);
+  free(row_d2);
+
+  return r;
 }
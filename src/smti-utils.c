@@ -300,7 +300,7 @@ SMP_Load_Problem(char *file_name, SMPInfo *p_smp_info)
   FILE *f;
   int format_is_dat = Has_Dat_Suffix(file_name);
 
-  if ((f = fopen(file_name, "rt")) == NULL) {
+  if ((f = Open_Instance(file_name)) == NULL) {
     perror(file_name);
     exit(1);
   }
@@ -313,7 +313,10 @@ SMP_Load_Problem(char *file_name, SMPInfo *p_smp_info)
     }
 
   if (p_smp_info == NULL)	/* only need the size */
-    return size;
+    {
+      fclose(f);
+      return size;
+    }
 
   p1 = Read_Integer(f, 0);
   if (p1 == RD_END_OF_FILE || p1 == RD_ERROR)
@@ -87,6 +87,7 @@ Solve(AdData *p_ad)
       SMP_Free_Matrix(revp_m, size);
       SMP_Free_Matrix(revp_w, size);
       pref_m = pref_w = NULL;
+      revp_m = revp_w = NULL;
     }
 #endif
 
@@ -114,24 +115,28 @@ Solve(AdData *p_ad)
   pref_w = smp_info.pref_w;
 
   int m, w, k, z, rank;
-  revp_m = SMP_Alloc_Matrix(size);
-  revp_w = SMP_Alloc_Matrix(size);
-  for(m = 0; m < size; m++)
+  if (revp_m == NULL)		/* new problem (else kept up to date by Apply_Delta) */
     {
-      memset(revp_m[m], -1, size * sizeof(revp_m[m][0])); /* everything set to -1 */
-      for(k = 0; (z = pref_m[m][k]) >= 0; k++)
+      revp_m = SMP_Alloc_Matrix(size);
+      revp_w = SMP_Alloc_Matrix(size);
+
+      for(m = 0; m < size; m++)
 	{
-	  Unpack(z, w, rank);
-	  revp_m[m][w] = rank;
+	  memset(revp_m[m], -1, size * sizeof(revp_m[m][0])); /* everything set to -1 */
+	  for(k = 0; (z = pref_m[m][k]) >= 0; k++)
+	    {
+	      Unpack(z, w, rank);
+	      revp_m[m][w] = rank;
+	    }
 	}
-    }
-  for(w = 0; w < size; w++)
-    {
-      memset(revp_w[w], -1, size * sizeof(revp_w[w][0])); /* everything set to -1 */
-      for(k = 0; (z = pref_w[w][k]) >= 0; k++)
+      for(w = 0; w < size; w++)
 	{
-	  Unpack(z, m, rank);
-	  revp_w[w][m] = rank;
+	  memset(revp_w[w], -1, size * sizeof(revp_w[w][0])); /* everything set to -1 */
+	  for(k = 0; (z = pref_w[w][k]) >= 0; k++)
+	    {
+	      Unpack(z, m, rank);
+	      revp_w[w][m] = rank;
+	    }
 	}
     }
 
@@ -141,6 +146,34 @@ Solve(AdData *p_ad)
 
 
 
+/*
+ *  FREE_PROBLEM
+ *
+ *  Forgets the current instance (the next Solve reads p_ad->param_file).
+ */
+
+void
+Free_Problem(AdData *p_ad)
+{
+  if (pref_m == NULL)
+    return;
+
+  SMP_Free_Matrix(pref_m, size);
+  SMP_Free_Matrix(pref_w, size);
+  SMP_Free_Matrix(revp_m, size);
+  SMP_Free_Matrix(revp_w, size);
+  free(sol_w);
+  free(error);
+  free(bp_swap);
+  pref_m = pref_w = revp_m = revp_w = NULL;
+  smp_info.pref_m = smp_info.pref_w = NULL;
+  sol_w = NULL;
+  error = bp_swap = NULL;
+}
+
+
+
+
 #define Find_Rank_In_Pref_M(m, w) (revp_m[m][w])
 #define Find_Rank_In_Pref_W(w, m) (revp_w[w][m])
 
@@ -459,6 +492,98 @@ Display_Solution(AdData *p_ad)
 
 
 
+/*
+ *  SET_PREF
+ *
+ *  Person p now ranks person q at rank r (-1: q is removed from the
+ *  list of p). The list stays sorted by rank (q is placed after the
+ *  persons of rank <= r) and revp is updated. O(length of the list).
+ */
+static void
+Set_Pref(SMPMatrix pref, SMPMatrix revp, int p, int q, int r)
+{
+  SMPInt *l = pref[p];
+  int k, n, z, q1, r1;
+
+  for(k = 0; (z = l[k]) >= 0; k++)
+    {
+      Unpack(z, q1, r1);
+      if (q1 == q)
+	break;
+    }
+  if (z >= 0)			/* remove q */
+    for(; (l[k] = l[k + 1]) >= 0; k++)
+      ;
+  n = k;			/* length of the list (without q) */
+
+  revp[p][q] = r;
+  if (r < 0)
+    return;
+
+  l[n + 1] = -1;
+  for(k = n; k > 0; k--)
+    {
+      Unpack(l[k - 1], q1, r1);
+      if (r1 <= r)
+	break;
+      l[k] = l[k - 1];
+    }
+  l[k] = Pack(q, r);
+}
+
+
+
+
+/*
+ *  APPLY_DELTA
+ *
+ *  Modifies the loaded instance, keeping the current matching. The delta
+ *  is a text with one change per line (persons and ranks start at 1):
+ *
+ *    m M W R       man M ranks woman W at rank R (0: W is removed)
+ *    w W M R       woman W ranks man M at rank R (0: M is removed)
+ *
+ *  Each change costs O(length of the list), the blocking pairs are then
+ *  recomputed by the engine from the current matching (returns -1).
+ */
+int
+Apply_Delta(AdData *p_ad, char *delta)
+{
+  char c, *p, *q;
+  int i, j, r, n, m;
+
+  for(p = delta; *p; p = q)
+    {
+      if ((q = strchr(p, '\n')) != NULL)
+	*q++ = '\0';
+      else
+	q = p + strlen(p);
+
+      if (sscanf(p, " %c%n", &c, &n) != 1 || c == '#')
+	continue;
+
+      if ((c != 'm' && c != 'w') || sscanf(p + n, "%d %d %d", &i, &j, &r) != 3 ||
+	  i < 1 || i > size || j < 1 || j > size || r < 0 || r > size)
+	{
+	  fprintf(stderr, "bad delta line: %s\n", p);
+	  return -2;
+	}
+
+      if (c == 'm')
+	Set_Pref(pref_m, revp_m, i - 1, j - 1, r - 1);
+      else
+	Set_Pref(pref_w, revp_w, i - 1, j - 1, r - 1);
+    }
+
+  for(m = 0; m < size; m++)	/* sol_w from the current matching */
+    sol_w[sol_m[m]] = m;
+
+  return -1;
+}
+
+
+
+
 int param_needed = -1;		/* overwrite var of main.c */
 
 
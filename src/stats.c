@@ -0,0 +1,315 @@
+/*
+ *  Adaptive search
+ *
+ *  Copyright (C) 2002-2011 Daniel Diaz, Philippe Codognet and Salvador Abreu
+ *
+ *  stats.c: run-time distribution statistics
+ *
+ *  Used by the bench harness (-b) to characterize the run-time
+ *  distribution of a set of independent runs and to predict the speedup
+ *  of an independent multi-walk execution (k walks, the first to solve
+ *  stops all): the run-time of k walks is the min of k runs.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "stats.h"
+
+/*-----------*
+ * Constants *
+ *-----------*/
+
+/*-------*
+ * Types *
+ *-------*/
+
+/*------------------*
+ * Global variables *
+ *------------------*/
+
+/*------------*
+ * Prototypes *
+ *------------*/
+
+
+
+
+static int
+Cmp_Double(const void *a, const void *b)
+{
+  double x = *(const double *) a;
+  double y = *(const double *) b;
+
+  return (x > y) - (x < y);
+}
+
+
+/*
+ *  STAT_SORT
+ *
+ *  Sorts a sample in increasing order (all other functions need a
+ *  sorted sample).
+ */
+void
+Stat_Sort(double *x, int n)
+{
+  qsort(x, n, sizeof(double), Cmp_Double);
+}
+
+
+
+
+/*
+ *  STAT_QUANTILE
+ *
+ *  Returns the q-quantile (q in [0..1]) with a linear interpolation
+ *  between the closest ranks.
+ */
+double
+Stat_Quantile(const double *sorted, int n, double q)
+{
+  double pos = q * (n - 1);
+  int i = (int) pos;
+
+  if (n == 0)
+    return 0;
+
+  if (i >= n - 1)
+    return sorted[n - 1];
+
+  return sorted[i] + (pos - i) * (sorted[i + 1] - sorted[i]);
+}
+
+
+
+
+/*
+ *  STAT_SUMMARY
+ *
+ *  Computes min, max, mean, standard deviation and some quantiles.
+ */
+void
+Stat_Summary(const double *sorted, int n, StatSummary *s)
+{
+  double sum = 0, sum2 = 0;
+  int i;
+
+  s->n = n;
+  if (n == 0)
+    {
+      s->min = s->max = s->mean = s->stddev = 0;
+      s->q10 = s->q25 = s->median = s->q75 = s->q90 = 0;
+      return;
+    }
+
+  for(i = 0; i < n; i++)
+    sum += sorted[i];
+  s->mean = sum / n;
+
+  for(i = 0; i < n; i++)	/* 2 passes: better precision */
+    sum2 += (sorted[i] - s->mean) * (sorted[i] - s->mean);
+  s->stddev = (n > 1) ? sqrt(sum2 / (n - 1)) : 0;
+
+  s->min = sorted[0];
+  s->max = sorted[n - 1];
+  s->q10 = Stat_Quantile(sorted, n, 0.10);
+  s->q25 = Stat_Quantile(sorted, n, 0.25);
+  s->median = Stat_Quantile(sorted, n, 0.50);
+  s->q75 = Stat_Quantile(sorted, n, 0.75);
+  s->q90 = Stat_Quantile(sorted, n, 0.90);
+}
+
+
+
+
+/*
+ *  KS_DISTANCE
+ *
+ *  Kolmogorov-Smirnov distance between the sample and a model (given
+ *  by its cumulative distribution function).
+ */
+static double
+KS_Distance(const double *sorted, int n, double (*cdf)(const void *, double), const void *model)
+{
+  double d = 0, f, e;
+  int i;
+
+  for(i = 0; i < n; i++)
+    {
+      f = (*cdf)(model, sorted[i]);
+      if ((e = fabs(f - (double) i / n)) > d)
+	d = e;
+      if ((e = fabs((double) (i + 1) / n - f)) > d)
+	d = e;
+    }
+
+  return d;
+}
+
+
+
+
+static double
+Shifted_Exp_Cdf(const void *model, double x)
+{
+  const StatExpFit *f = (const StatExpFit *) model;
+
+  return (x <= f->x0) ? 0 : 1 - exp(-f->lambda * (x - f->x0));
+}
+
+
+/*
+ *  STAT_FIT_SHIFTED_EXP
+ *
+ *  Maximum likelihood fit of a shifted exponential:
+ *  x0 = min, 1/lambda = mean - x0.
+ */
+void
+Stat_Fit_Shifted_Exp(const double *sorted, int n, StatExpFit *f)
+{
+  double sum = 0;
+  int i;
+
+  f->x0 = f->lambda = f->ks = 0;
+  if (n == 0)
+    return;
+
+  for(i = 0; i < n; i++)
+    sum += sorted[i];
+
+  f->x0 = sorted[0];
+  f->lambda = (sum / n > f->x0) ? 1 / (sum / n - f->x0) : HUGE_VAL;
+  f->ks = KS_Distance(sorted, n, Shifted_Exp_Cdf, f);
+}
+
+
+
+
+static double
+Lognormal_Cdf(const void *model, double x)
+{
+  const StatLogNormFit *f = (const StatLogNormFit *) model;
+
+  if (x <= 0)
+    return 0;
+
+  if (f->sigma == 0)
+    return (log(x) < f->mu) ? 0 : 1;
+
+  return 0.5 * erfc(-(log(x) - f->mu) / (f->sigma * M_SQRT2));
+}
+
+
+/*
+ *  STAT_FIT_LOGNORMAL
+ *
+ *  Maximum likelihood fit of a lognormal: mu and sigma are the mean and
+ *  the standard deviation of ln(x). Values <= 0 are ignored for the fit.
+ */
+void
+Stat_Fit_Lognormal(const double *sorted, int n, StatLogNormFit *f)
+{
+  double sum = 0, sum2 = 0;
+  int i, nb = 0;
+
+  for(i = 0; i < n; i++)
+    if (sorted[i] > 0)
+      {
+	sum += log(sorted[i]);
+	nb++;
+      }
+
+  f->mu = f->sigma = f->ks = 0;
+  if (nb == 0)
+    return;
+
+  f->mu = sum / nb;
+
+  for(i = 0; i < n; i++)
+    if (sorted[i] > 0)
+      sum2 += (log(sorted[i]) - f->mu) * (log(sorted[i]) - f->mu);
+  f->sigma = sqrt(sum2 / nb);
+
+  f->ks = KS_Distance(sorted, n, Lognormal_Cdf, f);
+}
+
+
+
+
+/*
+ *  STAT_EXPECTED_MIN
+ *
+ *  Expected value of the min of k independent draws from the empirical
+ *  distribution (bootstrap-like estimate without resampling):
+ *
+ *  P(min = sorted[i]) = ((n - i) / n)^k - ((n - i - 1) / n)^k
+ */
+double
+Stat_Expected_Min(const double *sorted, int n, int k)
+{
+  double e = 0, p_ge = 1, p_gt;
+  int i;
+
+  for(i = 0; i < n; i++)
+    {
+      p_gt = pow((double) (n - i - 1) / n, k);
+      e += (p_ge - p_gt) * sorted[i];
+      p_ge = p_gt;
+    }
+
+  return e;
+}
+
+
+
+
+/*
+ *  STAT_SHIFTED_EXP_EXPECTED_MIN
+ *
+ *  Expected value of the min of k draws of a shifted exponential:
+ *  x0 + 1 / (k lambda)  (the min of k exponentials is an exponential).
+ */
+double
+Stat_Shifted_Exp_Expected_Min(const StatExpFit *f, int k)
+{
+  return f->x0 + 1 / (k * f->lambda);
+}
+
+
+
+
+/*
+ *  STAT_WRITE_TTT
+ *
+ *  Writes time-to-target data (one line per run): the cumulative
+ *  probability (i - 0.5) / n, the ith smallest time and nb of
+ *  iterations, and the time predicted by the shifted exponential fit
+ *  for this probability (gnuplot: plot "FILE" using 2:1, "" using 4:1).
+ *
+ *  Returns 0 if the file cannot be created.
+ */
+int
+Stat_Write_TTT(const char *file_name, const double *sorted_time,
+	       const double *sorted_iter, int n, const StatExpFit *f)
+{
+  FILE *out;
+  double p;
+  int i;
+
+  if ((out = fopen(file_name, "wt")) == NULL)
+    return 0;
+
+  fprintf(out, "# prob time iters exp_fit_time (x0: %g lambda: %g)\n", f->x0, f->lambda);
+
+  for(i = 0; i < n; i++)
+    {
+      p = (i + 0.5) / n;
+      fprintf(out, "%.6f %.9f %.0f %.9f\n", p, sorted_time[i], sorted_iter[i],
+	      f->x0 - log(1 - p) / f->lambda);
+    }
+
+  fclose(out);
+  return 1;
+}
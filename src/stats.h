@@ -0,0 +1,69 @@
+/*
+ *  Adaptive search
+ *
+ *  Copyright (C) 2002-2011 Daniel Diaz, Philippe Codognet and Salvador Abreu
+ *
+ *  stats.h: run-time distribution statistics - header file
+ */
+
+#ifndef _STATS_H
+#define _STATS_H
+
+/*-----------*
+ * Constants *
+ *-----------*/
+
+/*-------*
+ * Types *
+ *-------*/
+
+typedef struct
+{
+  int n;			/* nb of values */
+  double min, max;
+  double mean, stddev;
+  double q10, q25, median, q75, q90;
+} StatSummary;
+
+
+typedef struct			/* shifted exponential: F(x) = 1 - exp(-lambda (x - x0)) */
+{
+  double x0;
+  double lambda;
+  double ks;			/* Kolmogorov-Smirnov distance to the sample */
+} StatExpFit;
+
+
+typedef struct			/* lognormal: ln(x) follows N(mu, sigma) */
+{
+  double mu;
+  double sigma;
+  double ks;			/* Kolmogorov-Smirnov distance to the sample */
+} StatLogNormFit;
+
+/*------------------*
+ * Global variables *
+ *------------------*/
+
+/*------------*
+ * Prototypes *
+ *------------*/
+
+void Stat_Sort(double *x, int n);
+
+double Stat_Quantile(const double *sorted, int n, double q);
+
+void Stat_Summary(const double *sorted, int n, StatSummary *s);
+
+void Stat_Fit_Shifted_Exp(const double *sorted, int n, StatExpFit *f);
+
+void Stat_Fit_Lognormal(const double *sorted, int n, StatLogNormFit *f);
+
+double Stat_Expected_Min(const double *sorted, int n, int k);
+
+double Stat_Shifted_Exp_Expected_Min(const StatExpFit *f, int k);
+
+int Stat_Write_TTT(const char *file_name, const double *sorted_time,
+		   const double *sorted_iter, int n, const StatExpFit *f);
+
+#endif /* _STATS_H */
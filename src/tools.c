@@ -6,6 +6,7 @@
  *  tools.c: utilities
  */
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
@@ -48,6 +49,10 @@
 
 static long start_real_time = 0;
 
+static char *mem_inst_name;	/* Open_Instance: instance in memory (or NULL) */
+static char *mem_inst_data;
+static size_t mem_inst_size;
+
 
 /*------------*
  * Prototypes *
@@ -127,6 +132,68 @@ Real_Time(void)
 
 
 
+/*
+ *  REAL_TIME_NS
+ *
+ *  returns the (monotonic) real time in nsecs.
+ */
+long long
+Real_Time_Ns(void)
+{
+#if defined(CLOCK_MONOTONIC) && !defined(CELL)
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#else
+  return (long long) Real_Time() * 1000000LL;
+#endif
+}
+
+
+
+/*
+ *  CPU_TIME_NS
+ *
+ *  returns the CPU time of the process (all threads) in nsecs.
+ */
+long long
+CPU_Time_Ns(void)
+{
+#if defined(CLOCK_PROCESS_CPUTIME_ID) && !defined(CELL)
+  struct timespec ts;
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#else
+  return (long long) User_Time() * 1000000LL;
+#endif
+}
+
+
+
+/*
+ *  THREAD_CPU_TIME_NS
+ *
+ *  returns the CPU time of the calling thread in nsecs (i.e. of one
+ *  walk when each walk is a thread).
+ */
+long long
+Thread_CPU_Time_Ns(void)
+{
+#if defined(CLOCK_THREAD_CPUTIME_ID) && !defined(CELL)
+  struct timespec ts;
+
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#else
+  return CPU_Time_Ns();
+#endif
+}
+
+
+
+
 /*
  *  RANDOMIZE_SEED
  *
@@ -610,6 +677,44 @@ Random_Permut_Check(int *vec, int size, const int *actual_value, int base_value)
 }
 
 
+
+
+/*
+ *  SET_MEMORY_INSTANCE
+ *
+ *  Records that the instance named name is the size bytes at data (e.g.
+ *  received by the server): Open_Instance(name) then reads them instead
+ *  of a file. name and data are not copied, name = NULL forgets it.
+ */
+void
+Set_Memory_Instance(char *name, char *data, size_t size)
+{
+  mem_inst_name = name;
+  mem_inst_data = data;
+  mem_inst_size = size;
+}
+
+
+
+
+/*
+ *  OPEN_INSTANCE
+ *
+ *  Opens the instance file_name for reading (the problems read their
+ *  instance with it, see Set_Memory_Instance).
+ */
+FILE *
+Open_Instance(char *file_name)
+{
+#ifndef CELL
+  if (mem_inst_name && strcmp(file_name, mem_inst_name) == 0)
+    return fmemopen(mem_inst_data, mem_inst_size, "r");
+#endif
+
+  return fopen(file_name, "rt");
+}
+
+
 #ifdef USE_ALONE
 
 #include <stdio.h>
@@ -9,10 +9,14 @@
 #ifndef _TOOLS_H
 #define _TOOLS_H
 
+#include <stdio.h>
+
 /*-----------*
  * Constants *
  *-----------*/
 
+#define Div_Round_Up(x, y)   (((x) + (y) - 1) / (y))
+
 /*-------*
  * Types *
  *-------*/
@@ -29,6 +33,12 @@ long Real_Time(void);
 
 long User_Time(void);
 
+long long Real_Time_Ns(void);
+
+long long CPU_Time_Ns(void);
+
+long long Thread_CPU_Time_Ns(void);
+
 
 void Randomize_Seed(unsigned seed);
 
@@ -51,6 +61,11 @@ void Random_Permut_Repair(int *vec, int size, const int *actual_value, int base_
 int Random_Permut_Check(int *vec, int size, const int *actual_value, int base_value);
 
 
+void Set_Memory_Instance(char *name, char *data, size_t size);
+
+FILE *Open_Instance(char *file_name);
+
+
 #ifndef No_Gcc_Warn_Unused_Result
 #define No_Gcc_Warn_Unused_Result(t) do { if(t) {} } while(0)
 #endif
@@ -0,0 +1,921 @@
+/*
+ *  Adaptive search
+ *
+ *  Copyright (C) 2002-2011 Daniel Diaz, Philippe Codognet and Salvador Abreu
+ *
+ *  walks.c: multi-walk (--walks)
+ *
+ *  NB independent walks (distinct seeds) solve the same instance and
+ *  the first one which reaches the target stops the others. Each walk
+ *  is a worker process connected to the coordinator (the main process)
+ *  by a stream socket. The protocol is made of text lines:
+ *
+ *    worker -> coordinator
+ *      hello SIZE               once connected (the instances must agree)
+ *      progress ITERS BEST      periodically during a walk
+ *      result REACHED COST RESTART ITER SWAP RESET LOCMIN SAMEVAR
+ *             ITER_TOT SWAP_TOT RESET_TOT LOCMIN_TOT SAMEVAR_TOT
+ *             USER_STAT CPU_NS : SOL...
+ *
+ *    coordinator -> worker
+ *      start SEED [OPTIONS]     do a walk with this seed (and these options)
+ *      stop                     stop the current walk asap (it sends its result)
+ *      quit                     the worker ends
+ *
+ *  By default the coordinator forks NB local workers (socketpairs). With
+ *  --coord=ADDR it waits for NB workers connecting to ADDR: a Unix
+ *  socket if ADDR contains a /, else [HOST]:PORT (TCP). A worker is
+ *  started (e.g. on another machine) with the same command line and
+ *  --worker=ADDR instead of --coord=ADDR (--walks=NB then starts NB
+ *  workers).
+ *
+ *  A run (each -b run) is one multi-walk: the seeds of the walks are
+ *  drawn from the seed of the run. The counters of the run are those of
+ *  the winning walk (the first one reaching the target, else the one
+ *  with the lowest cost) except the totals (_tot) which are summed over
+ *  all walks. The time of the run is the wall time, the CPU time is the
+ *  sum over all walks.
+ *
+ *  Portfolio (--portfolio): each walk has its own tuning options. A
+ *  portfolio file has one configuration per line (e.g. -P 80 -f 2 -p 10,
+ *  # starts a comment), walk k uses line k modulo the nb of lines. A
+ *  value MIN..MAX is drawn at random for each walk of each run (from
+ *  the seed of the run). With random, walk 0 keeps the options of the
+ *  command line and the others are drawn in the space of adtune (see
+ *  random_space). The winning walk of each run is recorded (fields walk
+ *  and walk_config, the drawn options) and the nb of wins of each
+ *  configuration is displayed after the -b runs.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifndef CELL
+#include <signal.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <poll.h>
+#include <errno.h>
+#endif
+
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+
+#include "ad_solver.h"
+#include "walks.h"
+
+/*-----------*
+ * Constants *
+ *-----------*/
+
+#define WALK_REPORT_MS     100	/* period of the progress reports of a walk */
+#define WALK_CONNECT_TRIES 100	/* a worker retries every 0.1 sec to connect */
+
+/*-------*
+ * Types *
+ *-------*/
+
+typedef struct			/* a multi-walk connection (coordinator <-> worker) */
+{
+  int fd;
+  char *buff;			/* received data not yet processed */
+  int len, size;
+  int used;			/* length of the line returned (to forget) */
+  int eof;
+  int running;			/* coordinator: the walk is running ? */
+} WalkConn;
+
+/*------------------*
+ * Global variables *
+ *------------------*/
+
+int nb_walks;			/* nb of walks of a run (0 = no multi-walk) */
+char *coord_addr;		/* address for remote workers (or NULL) */
+char *worker_addr;		/* this process is a worker of the coordinator at this address */
+
+char *portfolio;		/* portfolio file or "random" (or NULL) */
+char **walk_config;		/* [0..nb_walks-1] configuration of each walk (or NULL) */
+char **walk_opt;		/* [0..nb_walks-1] options of each walk in the current run */
+
+#ifndef CELL
+static WalkConn *walk;		/* coordinator: [0..nb_walks-1] the connections */
+static pid_t *walk_pid;		/* coordinator: the local workers (or 0) */
+static int *walk_wins;		/* [0..nb_walks-1] nb of runs won by each walk */
+
+/*------------*
+ * Prototypes *
+ *------------*/
+
+static int Set_Config(AdData *p_ad, AdData *base, char *config);
+
+static void Draw_Config(int k);
+
+static void End_Walks(void);
+
+
+
+
+static void
+Catch_Report(int sig)
+{
+  ad_report = 1;
+}
+
+/*
+ *  SET_CONFIG
+ *
+ *  Sets the tuning options of p_ad: those of base overwritten by the
+ *  options of config (e.g. "-P 80 -f 2"). Returns 0 on an error.
+ */
+static int
+Set_Config(AdData *p_ad, AdData *base, char *config)
+{
+  char opt[16];
+  int val, n;
+
+  p_ad->prob_select_loc_min = base->prob_select_loc_min;
+  p_ad->freeze_loc_min = base->freeze_loc_min;
+  p_ad->freeze_swap = base->freeze_swap;
+  p_ad->reset_limit = base->reset_limit;
+  p_ad->reset_percent = base->reset_percent;
+  p_ad->nb_var_to_reset = base->nb_var_to_reset;
+  p_ad->restart_limit = base->restart_limit;
+  p_ad->restart_max = base->restart_max;
+  p_ad->move_tries = base->move_tries;
+
+  while(sscanf(config, " %15s %d%n", opt, &val, &n) == 2)
+    {
+      config += n;
+      if (opt[0] != '-' || opt[1] == '\0' || opt[2] != '\0')
+	return 0;
+
+      switch(opt[1])
+	{
+	case 'P':
+	  p_ad->prob_select_loc_min = val;
+	  break;
+
+	case 'f':
+	  p_ad->freeze_loc_min = val;
+	  break;
+
+	case 'F':
+	  p_ad->freeze_swap = val;
+	  break;
+
+	case 'l':
+	  p_ad->reset_limit = val;
+	  if (p_ad->size > 0 && val >= p_ad->size)
+	    p_ad->reset_limit = p_ad->size - 1;
+	  break;
+
+	case 'p':
+	  p_ad->reset_percent = val;
+	  p_ad->nb_var_to_reset = Div_Round_Up(p_ad->size * val, 100);
+	  if (p_ad->nb_var_to_reset < 2)
+	    p_ad->nb_var_to_reset = 2;
+	  break;
+
+	case 'a':
+	  p_ad->restart_limit = val;
+	  break;
+
+	case 'r':
+	  p_ad->restart_max = val;
+	  break;
+
+	case 'm':
+	  p_ad->move_tries = val;
+	  break;
+
+	default:
+	  return 0;
+	}
+    }
+
+  return sscanf(config, " %15s", opt) != 1; /* nothing else */
+}
+
+
+
+
+/*
+ *  DRAW_CONFIG
+ *
+ *  Sets the options of walk k for a run (walk_opt): its configuration
+ *  with a value drawn at random for each MIN..MAX.
+ */
+static void
+Draw_Config(int k)
+{
+  char buff[1024], *p, *q = walk_opt[k];
+  int min, max;
+
+  *q = '\0';
+  strcpy(buff, walk_config[k]);
+  for(p = strtok(buff, " \t"); p; p = strtok(NULL, " \t"))
+    {
+      if (q > walk_opt[k])
+	*q++ = ' ';
+      if (sscanf(p, "%d..%d", &min, &max) == 2 && min <= max)
+	q += sprintf(q, "%d", Random_Interval(min, max));
+      else
+	q += sprintf(q, "%s", p);
+    }
+}
+
+
+
+
+/*
+ *  LOAD_PORTFOLIO
+ *
+ *  Gives its configuration to each walk (walk_config) and checks it.
+ *  Sets nb_walks if not given.
+ */
+void
+Load_Portfolio(AdData *p_ad)
+{
+  static char *random_space = "-P 0..100 -f 0..10 -F 0..5 -l 1..100 -p 1..50";
+  char **line = &random_space;
+  int nb_line = 1, size_line = 0;
+  char buff[1024], *p;
+  AdData scratch = *p_ad;
+  FILE *f;
+  int k;
+
+  if (strcmp(portfolio, "random") != 0)
+    {
+      if ((f = fopen(portfolio, "rt")) == NULL)
+	{
+	  perror(portfolio);
+	  exit(1);
+	}
+
+      line = NULL;
+      nb_line = 0;
+      while(fgets(buff, sizeof(buff), f))
+	{
+	  buff[strcspn(buff, "#\r\n")] = '\0';
+	  p = buff + strspn(buff, " \t");
+	  if (*p == '\0')
+	    continue;
+
+	  if (nb_line >= size_line)
+	    {
+	      size_line = size_line * 2 + 16;
+	      if ((line = realloc(line, size_line * sizeof(char *))) == NULL)
+		{
+		  fprintf(stderr, "%s:%d malloc failed\n", __FILE__, __LINE__);
+		  exit(1);
+		}
+	    }
+	  line[nb_line++] = strdup(p);
+	}
+      fclose(f);
+
+      if (nb_line == 0)
+	{
+	  fprintf(stderr, "%s: empty portfolio\n", portfolio);
+	  exit(1);
+	}
+    }
+
+  if (nb_walks <= 0)
+    nb_walks = nb_line;
+
+  walk_config = malloc(nb_walks * sizeof(char *));
+  walk_opt = malloc(nb_walks * sizeof(char *));
+  if (walk_config == NULL || walk_opt == NULL)
+    {
+      fprintf(stderr, "%s:%d malloc failed\n", __FILE__, __LINE__);
+      exit(1);
+    }
+
+  for(k = 0; k < nb_walks; k++)
+    {
+      walk_config[k] = (line == &random_space && k == 0) ? "" : line[k % nb_line];
+				/* a drawn value is not longer than MIN..MAX */
+      if ((walk_opt[k] = malloc(strlen(walk_config[k]) + 1)) == NULL)
+	{
+	  fprintf(stderr, "%s:%d malloc failed\n", __FILE__, __LINE__);
+	  exit(1);
+	}
+
+      Draw_Config(k);
+      if (!Set_Config(&scratch, p_ad, walk_opt[k]))
+	{
+	  fprintf(stderr, "%s: bad configuration: %s (options -P -f -F -l -p -a -r -m expected)\n",
+		  portfolio, walk_config[k]);
+	  exit(1);
+	}
+    }
+}
+
+
+
+
+/*
+ *  DISPLAY_PORTFOLIO
+ *
+ *  Displays the nb of runs won by each walk configuration.
+ */
+void
+Display_Portfolio(void)
+{
+  int k;
+
+  printf("\nportfolio: runs won by each walk configuration\n");
+  printf("| walk |  wins | configuration\n");
+  printf("|------|-------|--------------\n");
+  for(k = 0; k < nb_walks; k++)
+    printf("| %4d | %5d | %s\n", k, walk_wins[k],
+	   (*walk_config[k]) ? walk_config[k] : "(command line)");
+}
+
+
+static void
+Set_Report_Timer(int ms)	/* periodic (ms = 0: stop) */
+{
+  struct itimerval t;
+
+  memset(&t, 0, sizeof(t));
+  t.it_value.tv_sec = t.it_interval.tv_sec = ms / 1000;
+  t.it_value.tv_usec = t.it_interval.tv_usec = (ms % 1000) * 1000;
+  setitimer(ITIMER_REAL, &t, NULL);
+}
+
+
+
+
+/*
+ *  WALK_SOCKET
+ *
+ *  Returns a socket listening on addr (server) or connected to addr.
+ *  A worker retries for a while (the coordinator may not be ready).
+ */
+static int
+Walk_Socket(char *addr, int server)
+{
+  struct sockaddr_un un;
+  struct addrinfo hints, *res, *ai;
+  char host[256], *port;
+  int sock = -1, try, one = 1, err;
+
+  for(try = 0; try < WALK_CONNECT_TRIES; try++)
+    {
+      if (try > 0)
+	usleep(100000);
+
+      if (strchr(addr, '/'))	/* Unix socket */
+	{
+	  if ((sock = socket(AF_UNIX, SOCK_STREAM, 0)) < 0)
+	    break;
+	  memset(&un, 0, sizeof(un));
+	  un.sun_family = AF_UNIX;
+	  strncpy(un.sun_path, addr, sizeof(un.sun_path) - 1);
+	  if (server)
+	    {
+	      unlink(addr);
+	      if (bind(sock, (struct sockaddr *) &un, sizeof(un)) == 0 && listen(sock, 64) == 0)
+		return sock;
+	    }
+	  else if (connect(sock, (struct sockaddr *) &un, sizeof(un)) == 0)
+	    return sock;
+	  close(sock);
+	  sock = -1;
+	  if (server)
+	    break;
+	  continue;
+	}
+
+      if ((port = strrchr(addr, ':')) == NULL || port - addr >= (int) sizeof(host))
+	{
+	  fprintf(stderr, "%s: [HOST]:PORT or a Unix socket path expected\n", addr);
+	  exit(1);
+	}
+      sprintf(host, "%.*s", (int) (port - addr), addr);
+      port++;
+
+      memset(&hints, 0, sizeof(hints));
+      hints.ai_family = AF_UNSPEC;
+      hints.ai_socktype = SOCK_STREAM;
+      hints.ai_flags = (server) ? AI_PASSIVE : 0;
+      if ((err = getaddrinfo((*host) ? host : NULL, port, &hints, &res)) != 0)
+	{
+	  fprintf(stderr, "%s: %s\n", addr, gai_strerror(err));
+	  exit(1);
+	}
+
+      for(ai = res; ai != NULL; ai = ai->ai_next)
+	{
+	  if ((sock = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol)) < 0)
+	    continue;
+	  setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+	  if (server)
+	    {
+	      setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+	      if (bind(sock, ai->ai_addr, ai->ai_addrlen) == 0 && listen(sock, 64) == 0)
+		break;
+	    }
+	  else if (connect(sock, ai->ai_addr, ai->ai_addrlen) == 0)
+	    break;
+	  close(sock);
+	  sock = -1;
+	}
+      freeaddrinfo(res);
+
+      if (sock >= 0 || server)
+	break;
+    }
+
+  if (sock < 0)
+    {
+      perror(addr);
+      exit(1);
+    }
+
+  return sock;
+}
+
+
+
+
+/*
+ *  WALK_READ_LINE
+ *
+ *  Returns the next line received on a connection (without the \n) or
+ *  NULL if none is available (if !wait) or at the end of the stream.
+ *  The line is valid until the next call.
+ */
+static char *
+Walk_Read_Line(WalkConn *c, int wait)
+{
+  struct pollfd pfd;
+  char *p;
+  int n;
+
+  if (c->used > 0)		/* forget the line returned by the previous call */
+    {
+      c->len -= c->used;
+      memmove(c->buff, c->buff + c->used, c->len);
+      c->used = 0;
+    }
+
+  for(;;)
+    {
+      if ((p = memchr(c->buff, '\n', c->len)) != NULL)
+	{
+	  *p = '\0';
+	  c->used = p - c->buff + 1;
+	  return c->buff;
+	}
+
+      if (c->eof)
+	return NULL;
+
+      if (!wait)
+	{
+	  pfd.fd = c->fd;
+	  pfd.events = POLLIN;
+	  if (poll(&pfd, 1, 0) <= 0)
+	    return NULL;
+	}
+
+      if (c->size - c->len < 4096)
+	{
+	  c->size = c->size * 2 + 4096;
+	  if ((c->buff = realloc(c->buff, c->size)) == NULL)
+	    {
+	      fprintf(stderr, "%s:%d malloc failed\n", __FILE__, __LINE__);
+	      exit(1);
+	    }
+	}
+
+      if ((n = read(c->fd, c->buff + c->len, c->size - c->len)) < 0 && errno == EINTR)
+	continue;
+      if (n <= 0)
+	c->eof = 1;
+      else
+	c->len += n;
+    }
+}
+
+
+static void
+Walk_Write(int fd, char *buff, int len)
+{
+  int n;
+
+  while(len > 0)
+    {
+      if ((n = write(fd, buff, len)) < 0 && errno == EINTR)
+	continue;
+      if (n <= 0)
+	return;			/* the peer is gone (noticed when reading) */
+      buff += n;
+      len -= n;
+    }
+}
+
+
+#define Walk_Send(fd, ...)  (void) (dprintf(fd, __VA_ARGS__))
+
+
+
+
+/*
+ *  WALK_REPORT
+ *
+ *  Called by Ad_Solve (ad_report_fct) in a worker: sends the progress
+ *  and checks if the walk must be stopped.
+ */
+static WalkConn walk_self;	/* worker: the connection to the coordinator */
+
+static void
+Walk_Report(AdData *p_ad, int best_cost)
+{
+  char *line;
+
+  Walk_Send(walk_self.fd, "progress %d %d\n", p_ad->nb_iter_tot + p_ad->nb_iter, best_cost);
+
+  while((line = Walk_Read_Line(&walk_self, 0)) != NULL)
+    if (strcmp(line, "stop") == 0)
+      ad_stop = 1;
+
+  if (walk_self.eof)		/* the coordinator is gone */
+    ad_stop = 1;
+}
+
+
+
+
+/*
+ *  WALK_WORKER
+ *
+ *  The worker loop on a connection to the coordinator (does not return).
+ */
+static void
+Walk_Worker(AdData *p_ad, int fd)
+{
+  RunStat run_stat, *r = &run_stat;
+  AdData base = *p_ad;		/* the options of the command line */
+  static char *buff;
+  static int size;
+  char *line;
+  int seed, i, n;
+
+  walk_self.fd = fd;
+  ad_report_fct = Walk_Report;
+  signal(SIGALRM, Catch_Report);
+  signal(SIGPIPE, SIG_IGN);
+
+  Walk_Send(fd, "hello %d\n", p_ad->size);
+
+  while((line = Walk_Read_Line(&walk_self, 1)) != NULL && strcmp(line, "quit") != 0)
+    {
+      if (sscanf(line, "start %d%n", &seed, &n) != 1)
+	continue;		/* e.g. a stop received after the end of the walk */
+
+      if (!Set_Config(p_ad, &base, line + n))
+	{
+	  fprintf(stderr, "bad walk configuration: %s\n", line + n);
+	  exit(1);
+	}
+
+      ad_stop = 0;
+      Set_Report_Timer(WALK_REPORT_MS);
+      Do_Run(p_ad, seed, r);
+      Set_Report_Timer(0);
+      ad_report = 0;
+      Verify_Sol(p_ad);
+      fflush(stdout);
+
+      if (size < 256 + p_ad->size * 12)
+	{
+	  size = 256 + p_ad->size * 12;
+	  if ((buff = realloc(buff, size)) == NULL)
+	    {
+	      fprintf(stderr, "%s:%d malloc failed\n", __FILE__, __LINE__);
+	      exit(1);
+	    }
+	}
+
+      n = sprintf(buff, "result %d %d %d %d %d %d %d %d %d %d %d %d %d %d %lld :",
+		  r->reached, r->total_cost, r->nb_restart,
+		  r->nb_iter, r->nb_swap, r->nb_reset, r->nb_local_min, r->nb_same_var,
+		  r->nb_iter_tot, r->nb_swap_tot, r->nb_reset_tot, r->nb_local_min_tot,
+		  r->nb_same_var_tot, r->user_stat, r->cpu_ns);
+      for(i = 0; i < p_ad->size; i++)
+	n += sprintf(buff + n, " %d", p_ad->sol[i]);
+      buff[n++] = '\n';
+      Walk_Write(fd, buff, n);
+    }
+
+  exit(0);
+}
+
+
+
+
+/*
+ *  WALK_WORKERS
+ *
+ *  --worker=ADDR: starts the workers of this process (--walks=NB) which
+ *  connect to the coordinator (does not return).
+ */
+void
+Walk_Workers(AdData *p_ad)
+{
+  int k, n = (nb_walks > 0) ? nb_walks : 1;
+  pid_t pid;
+
+  fflush(stdout);
+  fflush(stderr);
+
+  for(k = 1; k < n; k++)	/* this process is worker 0 */
+    {
+      if ((pid = fork()) < 0)
+	{
+	  perror("fork");
+	  exit(1);
+	}
+      if (pid == 0)
+	{
+#ifdef __linux__
+	  prctl(PR_SET_PDEATHSIG, SIGTERM);
+#endif
+	  break;
+	}
+    }
+  if (k >= n)
+    k = 0;
+
+  if (pin_workers)
+    Pin_To_Cpu(k);
+
+  Walk_Worker(p_ad, Walk_Socket(worker_addr, 0));
+}
+
+
+
+
+/*
+ *  START_WALKS
+ *
+ *  Coordinator: gets the nb_walks connections (forked workers or
+ *  workers connecting to coord_addr).
+ */
+static void
+Start_Walks(AdData *p_ad)
+{
+  int sv[2];
+  int sock, i, k, size;
+  char *line;
+
+  walk = calloc(nb_walks, sizeof(WalkConn));
+  walk_pid = calloc(nb_walks, sizeof(pid_t));
+  walk_wins = calloc(nb_walks, sizeof(int));
+  if (walk == NULL || walk_pid == NULL || walk_wins == NULL)
+    {
+      fprintf(stderr, "%s:%d malloc failed\n", __FILE__, __LINE__);
+      exit(1);
+    }
+
+  signal(SIGPIPE, SIG_IGN);
+
+  if (coord_addr)
+    {
+      sock = Walk_Socket(coord_addr, 1);
+      printf("waiting for %d workers on %s\n", nb_walks, coord_addr);
+      for(k = 0; k < nb_walks; k++)
+	if ((walk[k].fd = accept(sock, NULL, NULL)) < 0)
+	  {
+	    perror("accept");
+	    exit(1);
+	  }
+      close(sock);
+      if (strchr(coord_addr, '/'))
+	unlink(coord_addr);
+    }
+  else
+    {
+      fflush(NULL);		/* stdout, stderr and the records */
+
+      for(k = 0; k < nb_walks; k++)
+	{
+	  if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0)
+	    {
+	      perror("socketpair");
+	      exit(1);
+	    }
+	  if ((walk_pid[k] = fork()) < 0)
+	    {
+	      perror("fork");
+	      exit(1);
+	    }
+
+	  if (walk_pid[k] == 0)	/* the worker */
+	    {
+	      close(sv[0]);
+	      for(i = 0; i < k; i++)
+		close(walk[i].fd);
+#ifdef __linux__
+	      prctl(PR_SET_PDEATHSIG, SIGTERM);
+#endif
+	      if (pin_workers)
+		Pin_To_Cpu(k);
+	      Walk_Worker(p_ad, sv[1]);
+	    }
+	  close(sv[1]);
+	  walk[k].fd = sv[0];
+	}
+    }
+
+  for(k = 0; k < nb_walks; k++)
+    if ((line = Walk_Read_Line(&walk[k], 1)) == NULL ||
+	sscanf(line, "hello %d", &size) != 1 || size != p_ad->size)
+      {
+	fprintf(stderr, "walk %d: bad worker (not the same instance ?)\n", k);
+	exit(1);
+      }
+
+  atexit(End_Walks);
+}
+
+
+
+
+/*
+ *  END_WALKS
+ *
+ *  Coordinator: ends the workers (called at exit).
+ */
+static void
+End_Walks(void)
+{
+  int k;
+
+  for(k = 0; k < nb_walks; k++)
+    {
+      Walk_Send(walk[k].fd, "quit\n");
+      close(walk[k].fd);
+    }
+
+  for(k = 0; k < nb_walks; k++)
+    if (walk_pid[k] > 0)
+      waitpid(walk_pid[k], NULL, 0);
+}
+
+
+
+
+/*
+ *  MULTI_WALK
+ *
+ *  Coordinator: does a run (nb_walks walks) with a given seed. The
+ *  solution of the winning walk is copied in p_ad->sol.
+ */
+void
+Multi_Walk(AdData *p_ad, int seed, RunStat *r)
+{
+  static struct pollfd *pfd;
+  RunStat w;
+  long long wall_ns0;
+  int nb_running = 0, winner = -1, stopped = 0;
+  int k, i, iters, best;
+  char *line, *p;
+
+  if (walk == NULL)
+    {
+      Start_Walks(p_ad);
+      if ((pfd = malloc(nb_walks * sizeof(struct pollfd))) == NULL)
+	{
+	  fprintf(stderr, "%s:%d malloc failed\n", __FILE__, __LINE__);
+	  exit(1);
+	}
+    }
+
+  wall_ns0 = Real_Time_Ns();	/* not counting the start of the workers */
+
+  Randomize_Seed(seed);		/* distinct seed streams for the walks */
+  for(k = 0; k < nb_walks; k++)
+    {
+      if (walk_config)
+	Draw_Config(k);
+      Walk_Send(walk[k].fd, "start %d %s\n", Run_Seed(), (walk_config) ? walk_opt[k] : "");
+      walk[k].running = 1;
+      nb_running++;
+    }
+
+  memset(r, 0, sizeof(*r));
+
+  while(nb_running > 0)
+    {
+      for(k = 0; k < nb_walks; k++)
+	{
+	  pfd[k].fd = (walk[k].running) ? walk[k].fd : -1;
+	  pfd[k].events = POLLIN;
+	}
+      if (poll(pfd, nb_walks, -1) < 0)
+	continue;		/* EINTR */
+
+      for(k = 0; k < nb_walks; k++)
+	{
+	  if (pfd[k].fd < 0 || pfd[k].revents == 0)
+	    continue;
+
+	  while(walk[k].running && (line = Walk_Read_Line(&walk[k], 0)) != NULL)
+	    {
+	      if (sscanf(line, "progress %d %d", &iters, &best) == 2)
+		{
+		  if (p_ad->debug > 0)
+		    printf("walk %d: %d iters, best cost: %d\n", k, iters, best);
+		  continue;
+		}
+
+	      if (sscanf(line, "result %d %d %d %d %d %d %d %d %d %d %d %d %d %d %lld",
+			 &w.reached, &w.total_cost, &w.nb_restart,
+			 &w.nb_iter, &w.nb_swap, &w.nb_reset, &w.nb_local_min, &w.nb_same_var,
+			 &w.nb_iter_tot, &w.nb_swap_tot, &w.nb_reset_tot, &w.nb_local_min_tot,
+			 &w.nb_same_var_tot, &w.user_stat, &w.cpu_ns) != 15 ||
+		  (p = strchr(line, ':')) == NULL)
+		continue;
+
+	      walk[k].running = 0;
+	      nb_running--;
+
+	      r->nb_iter_tot += w.nb_iter_tot;
+	      r->nb_swap_tot += w.nb_swap_tot;
+	      r->nb_reset_tot += w.nb_reset_tot;
+	      r->nb_local_min_tot += w.nb_local_min_tot;
+	      r->nb_same_var_tot += w.nb_same_var_tot;
+	      r->cpu_ns += w.cpu_ns;
+
+	      if (winner < 0 || (!r->reached && (w.reached || w.total_cost < r->total_cost)))
+		{
+		  winner = k;
+		  r->reached = w.reached;
+		  r->total_cost = w.total_cost;
+		  r->nb_restart = w.nb_restart;
+		  r->nb_iter = w.nb_iter;
+		  r->nb_swap = w.nb_swap;
+		  r->nb_reset = w.nb_reset;
+		  r->nb_local_min = w.nb_local_min;
+		  r->nb_same_var = w.nb_same_var;
+		  r->user_stat = w.user_stat;
+		  for(i = 0; i < p_ad->size; i++)
+		    p_ad->sol[i] = strtol(p + 1, &p, 10);
+		}
+
+	      if (w.reached && !stopped) /* global stop */
+		{
+		  stopped = 1;
+		  for(i = 0; i < nb_walks; i++)
+		    if (walk[i].running)
+		      Walk_Send(walk[i].fd, "stop\n");
+		}
+	    }
+
+	  if (walk[k].running && walk[k].eof)
+	    {
+	      fprintf(stderr, "\n*** walk %d: the worker died\n", k);
+	      exit(1);
+	    }
+	}
+    }
+
+  r->seed = seed;
+  r->walk = winner;
+  r->wall_ns = Real_Time_Ns() - wall_ns0;
+  r->time = r->wall_ns / 1e9;
+  walk_wins[winner]++;
+
+  if (p_ad->debug > 0)
+    printf("walk %d wins (cost: %d)\n", winner, r->total_cost);
+
+  p_ad->seed = seed;
+  p_ad->total_cost = r->total_cost;
+  p_ad->nb_restart = r->nb_restart;
+  p_ad->nb_iter = r->nb_iter;
+  p_ad->nb_swap = r->nb_swap;
+  p_ad->nb_reset = r->nb_reset;
+  p_ad->nb_local_min = r->nb_local_min;
+  p_ad->nb_same_var = r->nb_same_var;
+  p_ad->nb_iter_tot = r->nb_iter_tot;
+  p_ad->nb_swap_tot = r->nb_swap_tot;
+  p_ad->nb_reset_tot = r->nb_reset_tot;
+  p_ad->nb_local_min_tot = r->nb_local_min_tot;
+  p_ad->nb_same_var_tot = r->nb_same_var_tot;
+}
+
+
+#endif /* !CELL */
@@ -0,0 +1,76 @@
+/*
+ *  Adaptive search
+ *
+ *  Copyright (C) 2002-2011 Daniel Diaz, Philippe Codognet and Salvador Abreu
+ *
+ *  walks.h: multi-walk (--walks) - header file
+ */
+
+#ifndef _WALKS_H
+#define _WALKS_H
+
+#include "ad_solver.h"
+
+/*-----------*
+ * Constants *
+ *-----------*/
+
+#define Run_Seed()     ((int) Random(0x7FFFFFFF))
+
+/*-------*
+ * Types *
+ *-------*/
+
+typedef struct			/* the result of one run */
+{
+  int seed;			/* the seed of this run */
+  int reached;			/* target reached ? */
+  int total_cost;
+  int nb_restart;
+  int nb_iter, nb_swap, nb_reset, nb_local_min, nb_same_var;
+  int nb_iter_tot, nb_swap_tot, nb_reset_tot, nb_local_min_tot, nb_same_var_tot;
+  int user_stat;
+  double time;			/* CPU time of the walk (secs) */
+  long long wall_ns;		/* wall time (nsecs) */
+  long long cpu_ns;		/* CPU time of the walk (nsecs) */
+  int walk;			/* multi-walk: the winning walk (else -1) */
+  AdPerfPhase perf[AD_NB_PHASES]; /* counters per phase (if ad_has_perf) */
+  int perf_avail[AD_NB_COUNTERS];
+} RunStat;
+
+/*------------------*
+ * Global variables *
+ *------------------*/
+
+extern int nb_walks;		/* nb of walks of a run (0 = no multi-walk) */
+extern char *coord_addr;	/* address for remote workers (or NULL) */
+extern char *worker_addr;	/* this process is a worker of the coordinator at this address */
+
+extern char *portfolio;		/* portfolio file or "random" (or NULL) */
+extern char **walk_config;	/* [0..nb_walks-1] configuration of each walk (or NULL) */
+extern char **walk_opt;		/* [0..nb_walks-1] options of each walk in the current run */
+
+/*------------*
+ * Prototypes *
+ *------------*/
+
+void Walk_Workers(AdData *p_ad);
+
+void Multi_Walk(AdData *p_ad, int seed, RunStat *r);
+
+void Load_Portfolio(AdData *p_ad);
+
+void Display_Portfolio(void);
+
+
+/* provided by the bench harness (main.c) */
+
+extern int pin_workers;
+
+void Do_Run(AdData *p_ad, int seed, RunStat *r);
+
+void Verify_Sol(AdData *p_ad);
+
+void Pin_To_Cpu(int n);
+
+#endif /* _WALKS_H */